@@ -0,0 +1,72 @@
+/**
+ * @file Generates synthetic GFCG instances (GraphML networks and a matching LP) for stress and performance tests.
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include "generate_instance.hpp"
+#include "logging.hpp"
+
+namespace po = boost::program_options;
+
+int main(int argc, char** argv) {
+	InstanceParameters params;
+	std::string output;
+
+	po::options_description desc("Usage: generate_instance --output <dir> [options]\nOptions");
+	desc.add_options()
+		("help", "print this message")
+		("output", po::value<std::string>(&output)->required(), "directory for instance.lp and graphs/")
+		("networks", po::value<int>(&params.networks)->default_value(params.networks), "number of networks")
+		("slices", po::value<int>(&params.slices)->default_value(params.slices), "time slices per network")
+		("states-min", po::value<int>(&params.states_min)->default_value(params.states_min), "minimum states per slice of a network")
+		("states-max", po::value<int>(&params.states_max)->default_value(params.states_max), "maximum states per slice of a network")
+		("branching", po::value<int>(&params.branching)->default_value(params.branching), "outgoing arcs per state")
+		("constraints", po::value<int>(&params.constraints)->default_value(params.constraints), "number of pricing constraints")
+		("density", po::value<double>(&params.density)->default_value(params.density), "probability of an arc being part of its constraint")
+		("seed", po::value<std::uint64_t>(&params.seed)->default_value(params.seed), "random seed");
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	} catch (const po::error& e) {
+		std::cerr << e.what() << "\n" << desc << std::endl;
+		return 1;
+	}
+	if (params.networks < 1 || params.slices < 1 || params.states_min < 1 || params.states_max < params.states_min
+			|| params.branching < 1 || params.constraints < 1) {
+		std::cerr << "Invalid instance parameters\n" << desc << std::endl;
+		return 1;
+	}
+
+	loguru::init(argc, argv);
+	generate_instance(params, output);
+	LOG_F(INFO, "Wrote instance to %s", output.c_str());
+	return 0;
+}
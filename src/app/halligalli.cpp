@@ -27,7 +27,6 @@
 #include <string>
 #include <thread>
 
-#include <boost/asio/thread_pool.hpp>
 #include <nlohmann/json.hpp>
 #include <objscip/objscip.h>
 #include <objscip/objscipdefplugins.h>
@@ -35,10 +34,16 @@
 #include "DataManager.hpp"
 #include "FullPricer.hpp"
 #include "KShortestPricer.hpp"
+#include "ObjBranchruleArcFlow.hpp"
 #include "ObjPricerGFCG.hpp"
+#include "PerfCounters.hpp"
+#include "TaskPool.hpp"
+#include "Trace.hpp"
 #include "initialize.hpp"
-#include "loguru.hpp"
+#include "logging.hpp"
+#include "memory_usage.hpp"
 #include "reporting.hpp"
+#include "warm_start.hpp"
 
 using json = nlohmann::json;
 
@@ -51,6 +56,25 @@ int exec_main(int argc, char** argv) {
 	auto graphs_path = config["graphs"].get<std::string>();
 	auto tcount = config["threadcount"].get<int>();
 	auto pricing_strategy = config["pricing_strategy"].get<int>();
+	auto column_max_age = config["column_max_age"].get<int>();
+	auto column_cleanup_interval = config["column_cleanup_interval"].get<int>();
+	auto seed_strategy = config["seed_strategy"].get<int>();
+	auto seed_max_paths_per_network = config["seed_max_paths_per_network"].get<int>();
+	auto columns_import_path = config["columns_import"].get<std::string>();
+	auto columns_export_path = config["columns_export"].get<std::string>();
+	auto integer_paths = config["integer_paths"].get<bool>();
+	auto pricing_log_path = config["pricing_log"].get<std::string>();
+	auto trace_path = config["trace"].get<std::string>();
+	auto dual_trace_path = config["dual_trace"].get<std::string>();
+	auto memory_report_interval = config["memory_report_interval"].get<int>();
+	auto use_perf_counters = config["perf_counters"].get<bool>();
+	auto network_schedule = config["network_schedule"].get<int>();
+	auto numa_first_touch = config["numa_first_touch"].get<bool>();
+	auto parallel_network_min_edges = config["parallel_network_min_edges"].get<int>();
+	auto batch_identical_networks = config["batch_identical_networks"].get<bool>();
+	auto network_reduction = config["network_reduction"].get<bool>();
+	auto bound_pruning = config["bound_pruning"].get<bool>();
+	auto recent_path_min_columns = config["recent_path_min_columns"].get<int>();
 
 	if (lp_path.empty() || graphs_path.empty()) {
 		if (argc != 3) {
@@ -67,6 +91,20 @@ int exec_main(int argc, char** argv) {
 	for (const auto& logfile_config : config["logfiles"])
 		loguru::add_file(logfile_config["path"].get<std::string>().c_str(), loguru::Truncate, logfile_config["level"].get<int>());
 
+	std::unique_ptr<Trace> trace;
+	if (!trace_path.empty()) {
+		trace = std::make_unique<Trace>(trace_path);
+		g_trace = trace.get();
+	}
+
+	// counters are inherited by threads created later on, so they are opened before the thread pool
+	std::unique_ptr<PerfCounters> perf_counters;
+	if (use_perf_counters) {
+		perf_counters = std::make_unique<PerfCounters>();
+		if (perf_counters->is_available()) g_perf_counters = perf_counters.get();
+		else LOG_F(WARNING, "No hardware counters available, continuing without them");
+	}
+
 	static std::string pricer_name = "GFCG_Pricer";
 
 	SCIP* scip = NULL;
@@ -76,9 +114,16 @@ int exec_main(int argc, char** argv) {
 	// TODO should we turn off separation? profiling, recheck results against scip -f
 	SCIP_CALL( SCIPsetIntParam(scip, "presolving/maxrestarts", 0) );
 	SCIP_CALL( SCIPsetSeparating(scip, SCIP_PARAMSETTING_OFF, TRUE) );
+	// column aging deletes priced variables, which SCIP only allows if enabled explicitly
+	if (column_max_age > 0) {
+		SCIP_CALL( SCIPsetBoolParam(scip, "pricing/delvars", TRUE) );
+		SCIP_CALL( SCIPsetBoolParam(scip, "pricing/delvarsroot", TRUE) );
+	}
 
 	if (tcount <= 0) tcount = (std::thread::hardware_concurrency() > 0) ? std::thread::hardware_concurrency() : 1;
-	boost::asio::thread_pool tpool(tcount);
+	TaskPool tpool(tcount);
+	if (numa_first_touch && network_schedule == 2 && !tpool.pin_workers())
+		LOG_F(WARNING, "Could not bind all threads to a CPU, network memory may be placed on other NUMA nodes");
 
 	LOG_F(INFO, "Reading problem...");
 	SCIP_CALL( SCIPreadProb(scip, lp_path.c_str(), NULL) );
@@ -86,6 +131,9 @@ int exec_main(int argc, char** argv) {
 	LOG_F(INFO, "Preprocessing...");
 	DataManager data_manager;
 	initialize_container(scip, data_manager, tpool, graphs_path.c_str(), config["unneeded_constraints_substrings"].get<std::vector<std::string>>());
+	if (network_reduction) reduce_networks(data_manager, tpool);
+	seed_columns(scip, data_manager, tpool, seed_strategy, seed_max_paths_per_network, integer_paths);
+	if (!columns_import_path.empty()) import_columns(scip, data_manager, columns_import_path, integer_paths);
 
 	std::unique_ptr<ObjPricerGFCG> pricer;
 	if (pricing_strategy > 0) {
@@ -96,16 +144,35 @@ int exec_main(int argc, char** argv) {
 		pricer = std::make_unique<FullPricer>(scip, pricer_name, data_manager, tpool);
 	}
 	assert(pricer != nullptr);
+	if (column_max_age > 0) pricer->set_column_aging(column_max_age, column_cleanup_interval);
+	pricer->set_integer_paths(integer_paths);
+	if (!pricing_log_path.empty()) pricer->set_pricing_log(pricing_log_path);
+	if (!dual_trace_path.empty()) pricer->set_dual_trace(dual_trace_path);
+	pricer->set_memory_report_interval(memory_report_interval);
+	pricer->set_network_schedule(network_schedule);
+	pricer->set_first_touch(numa_first_touch);
+	pricer->set_parallel_network_min_edges(parallel_network_min_edges);
+	pricer->set_batch_identical_networks(batch_identical_networks);
+	pricer->set_bound_pruning(bound_pruning);
+	pricer->set_recent_path_min_columns(recent_path_min_columns);
 
 	SCIP_CALL( SCIPincludeObjPricer(scip, pricer.release(), true) );
 	SCIP_CALL( SCIPactivatePricer(scip, SCIPfindPricer(scip, pricer_name.c_str())) );
 
+	// branching on path variables would alter the pricing problem, so branch on arc flows instead
+	if (integer_paths) SCIP_CALL( SCIPincludeObjBranchrule(scip, new ObjBranchruleArcFlow(scip, "GFCG_ArcFlow", data_manager), true) );
+
 	LOG_F(INFO, "Solving...");
 	SCIP_CALL( SCIPsolve(scip) );
 
+	log_memory_usage(data_manager, "solving");
+
 	LOG_F(INFO, "Reporting...");
 	if (config["report_results_scip"].get<bool>()) SCIP_CALL( SCIPprintBestSol(scip, NULL, FALSE) );
 	if (config["report_results_csv"].get<bool>()) report_results_csv(scip, data_manager);
+	if (!columns_export_path.empty()) export_columns(scip, data_manager, columns_export_path);
+	if (trace) trace->write();
+	tpool.log_summary();
 
 	LOG_F(INFO, "Freeing SCIP object...");
 	SCIP_CALL( SCIPfree(&scip) );
@@ -0,0 +1,184 @@
+/**
+ * @file Replays the pricing calls of a recorded dual trace without solving any LP, for A/B comparisons of pricer implementations and options.
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
+#include <objscip/objscip.h>
+#include <objscip/objscipdefplugins.h>
+
+#include "DataManager.hpp"
+#include "DualTrace.hpp"
+#include "FullPricer.hpp"
+#include "KShortestPricer.hpp"
+#include "TaskPool.hpp"
+#include "initialize.hpp"
+#include "logging.hpp"
+
+namespace po = boost::program_options;
+using json = nlohmann::json;
+
+/** Replays the pricing calls of a recorded dual trace against the networks of an instance, without solving any LP
+ * The pricer and its options are taken from a solver configuration, such that runs with different settings can be compared.
+ * Prints one JSON line per pricing call with the time spent setting weights and computing shortest paths,
+ * the number of paths that would become columns and a checksum of their lengths.
+ */
+int main(int argc, char** argv) {
+	std::string trace_path;
+	std::string lp_path;
+	std::string graphs_path;
+	std::string config_path;
+	std::vector<std::string> unneeded_constraints_substrings;
+	int tcount;
+	int repeat;
+
+	po::options_description desc("Usage: replay_pricing --trace <file> --lp <file> --graphs <dir> [options]\nOptions");
+	desc.add_options()
+		("help", "print this message")
+		("trace", po::value<std::string>(&trace_path)->required(), "dual trace recorded by the solver (config key dual_trace)")
+		("lp", po::value<std::string>(&lp_path)->required(), "lp file of the recorded instance")
+		("graphs", po::value<std::string>(&graphs_path)->required(), "graph directory of the recorded instance")
+		("config", po::value<std::string>(&config_path), "solver configuration whose pricing options are replayed (pricing_strategy, network_schedule, ..., recent_path_min_columns), the pricer defaults without")
+		("unneeded", po::value<std::vector<std::string>>(&unneeded_constraints_substrings)->multitoken(), "unneeded constraint substrings of the recorded run, overrides the config")
+		("threads", po::value<int>(&tcount)->default_value(0), "worker threads, 0 for all cores, overrides the config")
+		("repeat", po::value<int>(&repeat)->default_value(1), "replay every pricing call this many times");
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	} catch (const po::error& e) {
+		std::cerr << e.what() << "\n" << desc << std::endl;
+		return 1;
+	}
+	if (repeat < 1) {
+		std::cerr << "repeat must be positive\n" << desc << std::endl;
+		return 1;
+	}
+
+	json config = json::object();
+	if (!config_path.empty()) {
+		std::ifstream config_stream(config_path);
+		if (!config_stream) {
+			std::cerr << "Could not open config " << config_path << std::endl;
+			return 1;
+		}
+		config_stream >> config;
+	}
+	// options missing from the config keep the defaults of the pricer
+	auto option = [&](const char* key, auto fallback) {
+		return config.contains(key) ? config[key].get<decltype(fallback)>() : fallback;
+	};
+	if (vm["threads"].defaulted()) tcount = option("threadcount", tcount);
+	if (!vm.count("unneeded")) unneeded_constraints_substrings = option("unneeded_constraints_substrings", std::vector<std::string>());
+	auto pricing_strategy = option("pricing_strategy", 0);
+	auto network_schedule = option("network_schedule", 1);
+	auto numa_first_touch = option("numa_first_touch", false);
+
+	loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+	loguru::init(argc, argv);
+
+	SCIP* scip = NULL;
+	SCIP_CALL( SCIPcreate(&scip) );
+	SCIP_CALL( SCIPincludeDefaultPlugins(scip) );
+	SCIP_CALL( SCIPreadProb(scip, lp_path.c_str(), NULL) );
+
+	if (tcount <= 0) tcount = (std::thread::hardware_concurrency() > 0) ? std::thread::hardware_concurrency() : 1;
+	TaskPool tpool(tcount);
+	if (numa_first_touch && network_schedule == 2 && !tpool.pin_workers())
+		LOG_F(WARNING, "Could not bind all threads to a CPU, network memory may be placed on other NUMA nodes");
+	DataManager data_manager;
+	initialize_container(scip, data_manager, tpool, graphs_path, unneeded_constraints_substrings);
+	if (option("network_reduction", false)) reduce_networks(data_manager, tpool);
+
+	// map the constraint order of the trace to the constraint order of this data manager
+	DualTraceReader reader(trace_path);
+	const auto& constraints = data_manager.get_constraints();
+	std::unordered_map<std::string, std::size_t> constraint_index;
+	for (std::size_t i = 0; i < constraints.size(); i++) constraint_index[SCIPconsGetName(constraints[i].scip_constraint)] = i;
+	std::vector<std::size_t> trace_to_index;
+	for (const auto &name : reader.get_constraint_names()) {
+		auto res = constraint_index.find(name);
+		if (res == constraint_index.end()) ABORT_F("Constraint %s of the dual trace is not a pricing constraint of the instance", name.c_str());
+		trace_to_index.push_back(res->second);
+	}
+	if (trace_to_index.size() != constraints.size())
+		LOG_F(WARNING, "%zu pricing constraints are not part of the dual trace, their duals are zero", constraints.size() - trace_to_index.size());
+
+	std::unique_ptr<ObjPricerGFCG> pricer;
+	if (pricing_strategy > 0) pricer = std::make_unique<KShortestPricer>(scip, "replay_pricer", data_manager, tpool, pricing_strategy);
+	else pricer = std::make_unique<FullPricer>(scip, "replay_pricer", data_manager, tpool);
+	pricer->set_network_schedule(network_schedule);
+	pricer->set_first_touch(numa_first_touch);
+	pricer->set_parallel_network_min_edges(option("parallel_network_min_edges", 0));
+	pricer->set_batch_identical_networks(option("batch_identical_networks", false));
+	pricer->set_bound_pruning(option("bound_pruning", false));
+	pricer->set_recent_path_min_columns(option("recent_path_min_columns", 0));
+	bool farkas;
+	std::vector<double> trace_duals;
+	std::vector<double> duals(constraints.size());
+	double total_ms = 0;
+	for (int call = 0; reader.read(farkas, trace_duals); call++) {
+		std::fill(duals.begin(), duals.end(), 0.0);
+		for (std::size_t i = 0; i < trace_duals.size(); i++) duals[trace_to_index[i]] = trace_duals[i];
+		for (int r = 0; r < repeat; r++) {
+			auto start = std::chrono::steady_clock::now();
+			auto paths = pricer->replay_pricing(scip, duals);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			total_ms += elapsed.count();
+
+			double checksum = 0;
+			double min_reduced_cost = 0;
+			for (const auto &path : paths) {
+				checksum += path.length;
+				min_reduced_cost = std::min(min_reduced_cost, path.length);
+			}
+			json line = {
+				{"call", call},
+				{"repetition", r},
+				{"farkas", farkas},
+				{"pricing_ms", elapsed.count()},
+				{"columns", paths.size()},
+				{"min_reduced_cost", min_reduced_cost},
+				{"checksum", checksum}
+			};
+			std::cout << line.dump() << "\n";
+		}
+	}
+	std::cout << json({{"total_pricing_ms", total_ms}}).dump() << std::endl;
+
+	SCIP_CALL( SCIPfree(&scip) );
+	return 0;
+}
@@ -0,0 +1,307 @@
+/**
+ * @file Microbenchmarks for the pricing hot paths of the halligalli library.
+ * Each benchmark prints one JSON object per line: name, parameters, iterations, ns/op, ops/s and heap allocations per op.
+ * Usage: bench_halligalli [--filter <substring>] [--min-time <ms>]
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <objscip/objscip.h>
+
+#include "Arc.hpp"
+#include "DataManager.hpp"
+#include "FullPricer.hpp"
+#include "Network.hpp"
+#include "NetworkBatch.hpp"
+#include "TaskPool.hpp"
+#include "generate_instance.hpp"
+#include "logging.hpp"
+#include "parse_lp.hpp"
+
+using json = nlohmann::json;
+
+/*
+ * Allocation accounting: all global allocations of the process are counted,
+ * benchmarks report the difference per operation.
+ * Every variant of the global operators is replaced, all of them allocate with malloc or aligned_alloc and release with free.
+ */
+static std::atomic<long> g_alloc_count(0);
+static std::atomic<long> g_alloc_bytes(0);
+
+/// Not inlined into the operators, so the compiler does not pair the new expressions of the program with free
+__attribute__((noinline)) static void * counted_alloc(std::size_t size, std::size_t alignment = 0) noexcept {
+	g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+	g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+	if (size == 0) size = 1;
+	if (alignment == 0) return std::malloc(size);
+	// aligned_alloc requires a multiple of the alignment
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+__attribute__((noinline)) static void counted_free(void * ptr) noexcept { std::free(ptr); }
+
+static void * counted_alloc_or_throw(std::size_t size, std::size_t alignment = 0) {
+	if (void * ptr = counted_alloc(size, alignment)) return ptr;
+	throw std::bad_alloc();
+}
+
+void * operator new(std::size_t size) { return counted_alloc_or_throw(size); }
+void * operator new[](std::size_t size) { return counted_alloc_or_throw(size); }
+void * operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void * operator new[](std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void * operator new(std::size_t size, std::align_val_t alignment) { return counted_alloc_or_throw(size, static_cast<std::size_t>(alignment)); }
+void * operator new[](std::size_t size, std::align_val_t alignment) { return counted_alloc_or_throw(size, static_cast<std::size_t>(alignment)); }
+void * operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return counted_alloc(size, static_cast<std::size_t>(alignment)); }
+void * operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return counted_alloc(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void * ptr) noexcept { counted_free(ptr); }
+void operator delete[](void * ptr) noexcept { counted_free(ptr); }
+void operator delete(void * ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete[](void * ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete(void * ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete[](void * ptr, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete(void * ptr, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete[](void * ptr, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept { counted_free(ptr); }
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(ptr); }
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(ptr); }
+
+struct BenchOptions {
+	std::string filter;
+	double min_time_ms = 200;
+};
+
+/** Run op repeatedly until min_time_ms has elapsed (after one warmup call) and print the measurement */
+void run_benchmark(const BenchOptions& options, const std::string& name, const json& params, const std::function<void()>& op) {
+	if (name.find(options.filter) == std::string::npos) return;
+	op();
+
+	long iterations = 0;
+	long allocs_before = g_alloc_count.load();
+	long bytes_before = g_alloc_bytes.load();
+	auto start = std::chrono::steady_clock::now();
+	std::chrono::duration<double, std::milli> elapsed(0);
+	long batch = 1;
+	while (elapsed.count() < options.min_time_ms) {
+		for (long i = 0; i < batch; i++) op();
+		iterations += batch;
+		batch *= 2;
+		elapsed = std::chrono::steady_clock::now() - start;
+	}
+	double ns_per_op = elapsed.count() * 1e6 / iterations;
+	json result = {
+		{"benchmark", name},
+		{"params", params},
+		{"iterations", iterations},
+		{"ns_per_op", ns_per_op},
+		{"ops_per_s", 1e9 / ns_per_op},
+		{"allocs_per_op", (double) (g_alloc_count.load() - allocs_before) / iterations},
+		{"alloc_bytes_per_op", (double) (g_alloc_bytes.load() - bytes_before) / iterations}
+	};
+	std::cout << result.dump() << std::endl;
+}
+
+/** Write a synthetic network of the instance generator with a fixed state count */
+void write_synthetic_network(const std::string& filename, int group, int n_slices, int n_states) {
+	InstanceParameters params;
+	params.slices = n_slices;
+	params.states_min = n_states;
+	params.states_max = n_states;
+	write_network(params, group, filename);
+}
+
+std::string format_var_name(const Arc& arc) {
+	auto node = [](const Node& n) {
+		auto negx = [](int i) { return i < 0 ? "neg" + std::to_string(-i) : std::to_string(i); };
+		return std::to_string(n.laufbahngruppe) + "|" + std::to_string(n.laufbahn) + "|"
+			+ negx(n.dienstgrad) + "|" + negx(n.zeitscheibe) + "|" + std::to_string(n.status) + "|"
+			+ (n.ausbildung ? "true" : "false") + "|" + std::to_string(n.netzwerk);
+	};
+	return "y(" + node(arc.source) + "," + node(arc.target) + ")";
+}
+
+struct NetworkInput {
+	std::string name;
+	std::string filename;
+	json params;
+};
+
+std::vector<NetworkInput> network_inputs(const std::string& tmp_dir) {
+	std::vector<NetworkInput> inputs = {
+		{"bundled", std::string(BENCH_RES) + "/test_graph_26.xml", {{"file", "test_graph_26.xml"}}},
+		{"bundled", std::string(BENCH_RES) + "/example_problem_graphs/ex_1.xml", {{"file", "ex_1.xml"}}}
+	};
+	for (auto size : {std::make_pair(10, 10), std::make_pair(40, 50), std::make_pair(100, 200)}) {
+		std::string filename = tmp_dir + "/synthetic_" + std::to_string(size.first * size.second) + "_1";
+		write_synthetic_network(filename, 1, size.first, size.second);
+		inputs.push_back({"synthetic", filename, {{"slices", size.first}, {"states", size.second}}});
+	}
+	return inputs;
+}
+
+void bench_network(const BenchOptions& options, const std::vector<NetworkInput>& inputs) {
+	for (const auto& input : inputs) {
+		std::vector<Arc> arcs;
+		Network net(input.filename, arcs);
+		json params = input.params;
+		params["input"] = input.name;
+		params["vertices"] = net.get_vertex_count();
+		params["edges"] = net.get_edge_count();
+
+		run_benchmark(options, "network_construct", params, [&]() {
+			std::vector<Arc> arc_list;
+			Network n(input.filename, arc_list);
+		});
+
+		// change one weight per call, otherwise the cached path would be returned
+		std::size_t i = 0;
+		ShortestPathScratch scratch;
+		run_benchmark(options, "network_shortest_path", params, [&]() {
+			net.set_edge_weight(arcs[i % arcs.size()], -((double) (i % 7)));
+			net.shortest_path(scratch);
+			i++;
+		});
+	}
+}
+
+/** Shortest paths of topologically identical networks, one scalar sweep each versus one batched sweep */
+void bench_network_batch(const BenchOptions& options, const std::string& tmp_dir) {
+	std::vector<Network> networks;
+	std::vector<std::vector<Arc>> arc_lists;
+	for (std::size_t group = 1; group <= NetworkBatch::c_lanes; group++) {
+		std::string filename = tmp_dir + "/synthetic_batch_" + std::to_string(group);
+		write_synthetic_network(filename, group, 40, 200);
+		arc_lists.emplace_back();
+		networks.emplace_back(filename, arc_lists.back());
+	}
+	std::vector<Network*> network_ptrs;
+	for (auto& net : networks) network_ptrs.push_back(&net);
+	json params = {{"input", "synthetic"}, {"networks", networks.size()}, {"edges", networks[0].get_edge_count()}};
+
+	// change one weight per network and call, otherwise the cached paths would be returned
+	std::size_t i = 0;
+	auto change_weights = [&]() {
+		for (std::size_t n = 0; n < networks.size(); n++)
+			networks[n].set_edge_weight(arc_lists[n][i % arc_lists[n].size()], -((double) ((i + n) % 7)));
+		i++;
+	};
+	ShortestPathScratch scratch;
+	run_benchmark(options, "network_batch_scalar", params, [&]() {
+		change_weights();
+		for (auto& net : networks) net.shortest_path(scratch);
+	});
+	auto batches = NetworkBatch::make_batches(network_ptrs);
+	assert(batches.size() == 1);
+	run_benchmark(options, "network_batch_shortest_paths", params, [&]() {
+		change_weights();
+		batches[0].shortest_paths();
+	});
+}
+
+void bench_parse_lp_var(const BenchOptions& options, const std::string& tmp_dir) {
+	std::vector<Arc> arcs;
+	std::string filename = tmp_dir + "/synthetic_parse_1";
+	write_synthetic_network(filename, 1, 20, 20);
+	Network net(filename, arcs);
+	std::vector<std::string> names;
+	for (const auto& arc : arcs) names.push_back(format_var_name(arc));
+
+	std::size_t i = 0;
+	run_benchmark(options, "parse_lp_var", {{"input", "synthetic"}, {"names", names.size()}}, [&]() {
+		auto arc = parse_lp_var(names[i % names.size()]);
+		assert(arc);
+		i++;
+	});
+}
+
+/** set_arc_weights without the SCIP LP: one constraint per (slice, state) over all networks, as in the planning LPs */
+void bench_set_arc_weights(const BenchOptions& options, const std::string& tmp_dir, TaskPool& tpool) {
+	for (int n_networks : {4, 32}) {
+		SCIP * scip = NULL;
+		SCIP_CALL_ABORT( SCIPcreate(&scip) );
+		DataManager data_manager;
+		std::map<std::pair<int, int>, Constraint> constraints;
+		for (int group = 1; group <= n_networks; group++) {
+			std::string filename = tmp_dir + "/synthetic_weights_" + std::to_string(group);
+			write_synthetic_network(filename, group, 20, 50);
+			std::vector<Arc> arcs;
+			Network net(filename, arcs);
+			data_manager.add_network(group, std::move(net));
+			data_manager.add_arcs_of_network(group, arcs);
+			for (const auto& arc : arcs) {
+				auto& cons = constraints[std::make_pair(arc.target.zeitscheibe, arc.target.dienstgrad)];
+				cons.scip_constraint = NULL;
+				cons.arcs.push_back(std::make_pair(arc, 1.0));
+			}
+		}
+		for (auto& pair : constraints) data_manager.add_constraint(pair.second);
+
+		FullPricer pricer(scip, "bench_pricer", data_manager, tpool);
+		std::vector<double> duals(constraints.size());
+		for (std::size_t i = 0; i < duals.size(); i++) duals[i] = (i % 3 == 0) ? 0.0 : -1.0 - (double) (i % 5);
+
+		json params = {{"input", "synthetic"}, {"networks", n_networks}, {"constraints", duals.size()}};
+		run_benchmark(options, "set_arc_weights", params, [&]() {
+			pricer.apply_arc_weights(duals);
+		});
+		SCIP_CALL_ABORT( SCIPfree(&scip) );
+	}
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--filter") options.filter = argv[i + 1];
+		else if (arg == "--min-time") options.min_time_ms = std::stod(argv[i + 1]);
+		else {
+			std::cerr << "Usage: bench_halligalli [--filter <substring>] [--min-time <ms>]" << std::endl;
+			return 1;
+		}
+	}
+	loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+	auto tmp_dir = std::filesystem::temp_directory_path() / "halligalli_bench";
+	std::filesystem::create_directories(tmp_dir);
+	int tcount = (std::thread::hardware_concurrency() > 0) ? std::thread::hardware_concurrency() : 1;
+	TaskPool tpool(tcount);
+
+	bench_network(options, network_inputs(tmp_dir));
+	bench_network_batch(options, tmp_dir);
+	bench_parse_lp_var(options, tmp_dir);
+	bench_set_arc_weights(options, tmp_dir, tpool);
+
+	tpool.join();
+	std::filesystem::remove_all(tmp_dir);
+	return 0;
+}
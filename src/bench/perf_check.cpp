@@ -0,0 +1,185 @@
+/**
+ * @file Performance regression check of the solver against a checked-in baseline.
+ * Runs the solver on an instance with a pricing log, and compares the number of pricing iterations, the generated columns
+ * and the normalized runtime with the baseline entry of the instance. The runtime is normalized by a fixed shortest path
+ * workload measured right before, such that baselines remain comparable across machines of similar architecture.
+ * Usage: perf_check --solver <exe> --config <json> --lp <file> --graphs <dir> --baseline <json> --name <instance> [--update]
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
+
+#include "Arc.hpp"
+#include "Network.hpp"
+#include "generate_instance.hpp"
+#include "logging.hpp"
+
+namespace po = boost::program_options;
+using json = nlohmann::json;
+
+/** Milliseconds of a fixed single threaded workload: repeated shortest paths on a synthetic network under changing weights */
+double calibrate(const std::string& work_dir) {
+	InstanceParameters params;
+	params.slices = 40;
+	params.states_min = 50;
+	params.states_max = 50;
+	// the network group is parsed from the suffix of the filename
+	std::string filename = work_dir + "/calibration_1";
+	write_network(params, 1, filename);
+	std::vector<Arc> arcs;
+	Network net(filename, arcs);
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < 2000; i++) {
+		net.set_edge_weight(arcs[i % arcs.size()], -((double) (i % 7)));
+		net.shortest_path();
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+/** Compare a measurement with its baseline, larger values are regressions
+ * @return false if the measurement exceeds the baseline by more than the tolerance, or the baseline lacks the metric
+ */
+bool check(const std::string& metric, double value, const json& baseline, double tolerance) {
+	if (!baseline.contains(metric)) {
+		std::cout << metric << ": " << value << " (no baseline) FAILED" << std::endl;
+		return false;
+	}
+	double reference = baseline[metric].get<double>();
+	double limit = reference * (1 + tolerance);
+	std::cout << metric << ": " << value << " (baseline " << reference << ", limit " << limit << ")";
+	if (value > limit) {
+		std::cout << " REGRESSION" << std::endl;
+		return false;
+	}
+	if (value < reference * (1 - tolerance)) std::cout << " improved, consider updating the baseline";
+	std::cout << std::endl;
+	return true;
+}
+
+int main(int argc, char** argv) {
+	std::string solver, config_path, lp, graphs, baseline_path, name;
+	int tcount;
+	bool update = false;
+
+	po::options_description desc("Usage: perf_check --solver <exe> --config <json> --lp <file> --graphs <dir> --baseline <json> --name <instance> [options]\nOptions");
+	desc.add_options()
+		("help", "print this message")
+		("solver", po::value<std::string>(&solver)->required(), "solver executable")
+		("config", po::value<std::string>(&config_path)->required(), "solver configuration the run is based on")
+		("lp", po::value<std::string>(&lp)->required(), "lp file of the instance")
+		("graphs", po::value<std::string>(&graphs)->required(), "graph directory of the instance")
+		("baseline", po::value<std::string>(&baseline_path)->required(), "baseline file")
+		("name", po::value<std::string>(&name)->required(), "name of the instance in the baseline")
+		("threads", po::value<int>(&tcount)->default_value(1), "solver threads, a single thread keeps the iteration count reproducible")
+		("update", po::bool_switch(&update), "store the measurement as the new baseline of the instance instead of checking it");
+
+	po::variables_map vm;
+	try {
+		po::store(po::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(vm);
+	} catch (const po::error& e) {
+		std::cerr << e.what() << "\n" << desc << std::endl;
+		return 1;
+	}
+	loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+
+	// the solver reads config.json from its working directory
+	auto work_dir = (std::filesystem::temp_directory_path() / ("halligalli_perf_" + name)).string();
+	std::filesystem::remove_all(work_dir);
+	std::filesystem::create_directories(work_dir);
+	json config;
+	std::ifstream(config_path) >> config;
+	config["lp"] = std::filesystem::absolute(lp).string();
+	config["graphs"] = std::filesystem::absolute(graphs).string();
+	config["threadcount"] = tcount;
+	config["loglevel"] = -1;
+	config["logfiles"] = json::array();
+	config["report_results_scip"] = false;
+	config["report_results_csv"] = false;
+	config["pricing_log"] = work_dir + "/pricing.jsonl";
+	std::ofstream(work_dir + "/config.json") << config.dump(1, '\t');
+
+	double calibration_ms = calibrate(work_dir);
+	std::string command = "cd \"" + work_dir + "\" && \"" + std::filesystem::absolute(solver).string() + "\" > solver.out 2>&1";
+	auto start = std::chrono::steady_clock::now();
+	int status = std::system(command.c_str());
+	std::chrono::duration<double, std::milli> runtime = std::chrono::steady_clock::now() - start;
+	if (status != 0) {
+		std::cerr << "Solver failed with status " << status << ", output in " << work_dir << "/solver.out" << std::endl;
+		return 1;
+	}
+
+	int iterations = 0;
+	long columns = 0;
+	std::ifstream pricing_log(work_dir + "/pricing.jsonl");
+	for (std::string line; std::getline(pricing_log, line);) {
+		auto record = json::parse(line);
+		iterations++;
+		columns += record["columns_added"].get<long>();
+	}
+	json measurement = {
+		{"iterations", iterations},
+		{"columns", columns},
+		{"runtime_ms", runtime.count()},
+		{"calibration_ms", calibration_ms},
+		{"normalized_runtime", runtime.count() / calibration_ms}
+	};
+	std::cout << name << ": " << measurement.dump() << std::endl;
+
+	json baseline;
+	std::ifstream(baseline_path) >> baseline;
+	if (update) {
+		baseline["instances"][name] = measurement;
+		std::ofstream(baseline_path) << baseline.dump(1, '\t') << "\n";
+		std::cout << "Updated baseline of " << name << " in " << baseline_path << std::endl;
+		std::filesystem::remove_all(work_dir);
+		return 0;
+	}
+	// a missing baseline must not pass silently, otherwise the check never fails
+	if (!baseline["instances"].contains(name)) {
+		std::cout << "No baseline for " << name << " FAILED, record one on the reference machine with --update" << std::endl;
+		std::filesystem::remove_all(work_dir);
+		return 1;
+	}
+
+	const auto& reference = baseline["instances"][name];
+	const auto& tolerance = baseline["tolerance"];
+	bool passed = true;
+	passed &= check("iterations", iterations, reference, tolerance["iterations"].get<double>());
+	passed &= check("columns", columns, reference, tolerance["columns"].get<double>());
+	passed &= check("normalized_runtime", runtime.count() / calibration_ms, reference, tolerance["normalized_runtime"].get<double>());
+	std::filesystem::remove_all(work_dir);
+	return passed ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "Arc.hpp"
 
+#include <cstdio>
 #include <tuple>
 
 /** Less operator such that arcs may be used as keys in associative containers
@@ -21,21 +22,15 @@ bool Arc::operator==(const Arc& rhs) const {
  * @return The arc in human readable form, as presented in LP files.
  */
 std::string Arc::to_string() const {
-	return "y("
-		+ std::to_string(source.laufbahngruppe) + "|"
-		+ std::to_string(source.laufbahn) + "|"
-		+ std::to_string(source.dienstgrad) + "|"
-		+ std::to_string(source.zeitscheibe) + "|"
-		+ std::to_string(source.status) + "|"
-		+ std::to_string(source.ausbildung) + "|"
-		+ std::to_string(source.netzwerk) + ","
-		+ std::to_string(target.laufbahngruppe) + "|"
-		+ std::to_string(target.laufbahn) + "|"
-		+ std::to_string(target.dienstgrad) + "|"
-		+ std::to_string(target.zeitscheibe) + "|"
-		+ std::to_string(target.status) + "|"
-		+ std::to_string(target.ausbildung) + "|"
-		+ std::to_string(target.netzwerk) + ")";
+	return format().c_str();
+}
+
+ArcString Arc::format() const {
+	ArcString str;
+	std::snprintf(str.text, sizeof(str.text), "y(%d|%d|%d|%d|%d|%d|%d,%d|%d|%d|%d|%d|%d|%d)",
+			source.laufbahngruppe, source.laufbahn, source.dienstgrad, source.zeitscheibe, source.status, source.ausbildung, source.netzwerk,
+			target.laufbahngruppe, target.laufbahn, target.dienstgrad, target.zeitscheibe, target.status, target.ausbildung, target.netzwerk);
+	return str;
 }
 
 std::ostream& Arc::operator<<(std::ostream& stream) const {
@@ -28,11 +28,20 @@
 
 #include "Node.hpp"
 
+/** Textual representation of an arc in a fixed size buffer, large enough for fourteen integers and separators */
+struct ArcString {
+	char text[192];
+
+	const char* c_str() const { return text; }
+};
+
 /** The struct representing an arc of the problem, appearing as y-variables in the LP and as nodes in the networks */
 struct Arc {
 	bool operator<(const Arc& rhs) const;
 	bool operator==(const Arc& rhs) const;
 	std::string to_string() const;
+	/// Same representation as to_string(), but without allocating, e.g. for logging in hot paths
+	ArcString format() const;
 	std::ostream& operator<<(std::ostream& stream) const;
 
 	Node source;
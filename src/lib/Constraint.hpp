@@ -41,4 +41,15 @@ struct Constraint {
 	std::vector<std::pair<Arc, double>> arcs;
 };
 
+/** Represents a branching decision on the aggregated flow over an arc, created by ObjBranchruleArcFlow.
+ * The constraint contains every path variable using the arc with coefficient one and is only active in the subtree of its node.
+ * Its dual price is added to the weight of the corresponding edge, such that pricing remains a shortest path problem. <br>
+ * If forbidden is set, the flow over the arc is bounded by zero and the edge is excluded from pricing altogether.
+ */
+struct ArcFlowConstraint {
+	SCIP_CONS * scip_constraint;
+	Arc arc;
+	bool forbidden;
+};
+
 #endif
@@ -31,6 +31,10 @@ std::unordered_map<int, Network>& DataManager::get_networks() {
 	const std::lock_guard<std::mutex> lock(networks_mutex_);
 	return networks_;
 }
+const std::vector<Network*>& DataManager::get_network_list() {
+	const std::lock_guard<std::mutex> lock(networks_mutex_);
+	return network_list_;
+}
 std::unordered_map<Arc, std::vector<std::pair<SCIP_CONS *, double> > >& DataManager::get_arc_to_scip_constraints_map() {
 	const std::lock_guard<std::mutex> lock(arc_to_scip_constraints_mutex_);
 	return arc_to_scip_constraints_;
@@ -59,6 +63,18 @@ const boost::optional<const std::vector<DataManager::constraint_data_t>& > DataM
 		boost::optional<const std::vector<DataManager::constraint_data_t>& >{};
 }
 
+const boost::optional<const std::vector<DataManager::constraint_data_t>& > DataManager::get_arc_flow_constraints_of_arc(const Arc& arc) const {
+	auto res = arc_to_arc_flow_constraints_.find(arc);
+	return (res != arc_to_arc_flow_constraints_.end()) ?
+		res->second :
+		boost::optional<const std::vector<DataManager::constraint_data_t>& >{};
+}
+
+std::vector<ArcFlowConstraint>& DataManager::get_arc_flow_constraints() {
+	const std::lock_guard<std::mutex> lock(arc_flow_constraints_mutex_);
+	return arc_flow_constraints_;
+}
+
 const boost::optional<const Path&> DataManager::get_path(const std::string& varname) const {
 	auto res = generated_var_to_path_.find(varname);
 	return (res != generated_var_to_path_.end()) ?
@@ -73,7 +89,9 @@ void DataManager::add_constraint(Constraint cons) {
 
 void DataManager::add_network(int group, Network net) {
 	const std::lock_guard<std::mutex> lock(networks_mutex_);
-	networks_.insert(std::make_pair(group, net));
+	auto res = networks_.insert(std::make_pair(group, net));
+	// pointers to elements of an unordered_map stay valid on rehashing
+	if (res.second) network_list_.push_back(&res.first->second);
 }
 
 void DataManager::add_scip_constraint_to_arc(const Arc& arc, SCIP_CONS * scip_cons, double coeff) {
@@ -95,7 +113,66 @@ void DataManager::add_arcs_of_network(const int group, std::vector<Arc> arcs) {
 	}
 }
 
+void DataManager::add_arc_flow_constraint(ArcFlowConstraint cons) {
+	const std::lock_guard<std::mutex> lock(arc_flow_constraints_mutex_);
+	arc_to_arc_flow_constraints_[cons.arc].push_back(std::make_pair(cons.scip_constraint, 1.0));
+	arc_flow_constraints_.push_back(cons);
+}
+
+void DataManager::clear_arc_flow_constraints() {
+	const std::lock_guard<std::mutex> lock(arc_flow_constraints_mutex_);
+	arc_to_arc_flow_constraints_.clear();
+	arc_flow_constraints_.clear();
+}
+
 void DataManager::add_var_path_pair(std::string varname, Path path) {
 	const std::lock_guard<std::mutex> lock(generated_var_to_path_mutex_);
 	generated_var_to_path_.insert(std::make_pair(varname, path));
 }
+
+void DataManager::remove_var_path_pair(const std::string& varname) {
+	const std::lock_guard<std::mutex> lock(generated_var_to_path_mutex_);
+	generated_var_to_path_.erase(varname);
+}
+
+/** The estimates iterate over constraints, constraint arcs and generated paths, but never over the graphs themselves */
+memory_usage_t DataManager::get_memory_usage() {
+	memory_usage_t usage;
+
+	std::size_t constraint_bytes = vector_bytes(constraints_);
+	for (const auto &cons : constraints_) constraint_bytes += vector_bytes(cons.arcs);
+	usage.emplace_back("constraints", constraint_bytes);
+
+	std::size_t graph_bytes = 0;
+	std::size_t network_map_bytes = unordered_map_bytes(networks_);
+	for (const auto &net : networks_) {
+		graph_bytes += net.second.get_graph_bytes();
+		network_map_bytes += net.second.get_map_bytes();
+	}
+	usage.emplace_back("network graphs", graph_bytes);
+	usage.emplace_back("network maps", network_map_bytes);
+
+	std::size_t arc_to_constraints_bytes = unordered_map_bytes(arc_to_scip_constraints_);
+	for (const auto &pair : arc_to_scip_constraints_) arc_to_constraints_bytes += vector_bytes(pair.second);
+	usage.emplace_back("arc to constraints", arc_to_constraints_bytes);
+	usage.emplace_back("arc to network", unordered_map_bytes(arc_to_network_));
+
+	{
+		const std::lock_guard<std::mutex> lock(arc_flow_constraints_mutex_);
+		std::size_t arc_flow_bytes = vector_bytes(arc_flow_constraints_) + unordered_map_bytes(arc_to_arc_flow_constraints_);
+		for (const auto &pair : arc_to_arc_flow_constraints_) arc_flow_bytes += vector_bytes(pair.second);
+		usage.emplace_back("arc flow constraints", arc_flow_bytes);
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock(generated_var_to_path_mutex_);
+		std::size_t path_bytes = unordered_map_bytes(generated_var_to_path_);
+		for (const auto &pair : generated_var_to_path_) {
+			// short names are stored inline (small string optimization)
+			if (pair.first.capacity() > 15) path_bytes += pair.first.capacity() + 1;
+			path_bytes += vector_bytes(pair.second.arcs);
+		}
+		usage.emplace_back("path store", path_bytes);
+	}
+	return usage;
+}
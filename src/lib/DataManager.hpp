@@ -37,6 +37,7 @@
 #include "Constraint.hpp"
 #include "Network.hpp"
 #include "Path.hpp"
+#include "memory_usage.hpp"
 
 /** Stores and provides all relations and data needed for the column generation procedure in a thread safe manner */
 class DataManager {
@@ -45,11 +46,16 @@ class DataManager {
 
 		std::vector<Constraint>& get_constraints();
 		std::unordered_map<int, Network>& get_networks();
+		/// All networks in the order they were added, for indexed iteration, e.g. by TaskPool::parallel_for
+		const std::vector<Network*>& get_network_list();
 		std::unordered_map<Arc, std::vector<constraint_data_t> >& get_arc_to_scip_constraints_map();
 		Network& get_network(const int group);
 		Network& get_network(const Arc& arc);
 		/// Returns all constraints which contain this arc in the master lp
 		const boost::optional<const std::vector<constraint_data_t>& > get_constraints_of_arc(const Arc& arc) const;
+		/// Returns all arc flow branching constraints that contain this arc, active or not
+		const boost::optional<const std::vector<constraint_data_t>& > get_arc_flow_constraints_of_arc(const Arc& arc) const;
+		std::vector<ArcFlowConstraint>& get_arc_flow_constraints();
 		/// Returns the path corresponding to a generated variable
 		const boost::optional<const Path&> get_path(const std::string& varname) const;
 
@@ -59,8 +65,16 @@ class DataManager {
 		void add_scip_constraint_to_arc(const Arc& arc, SCIP_CONS * scip_cons, double coeff);
 		/// Stores information about the arcs present in a network (represented by its unique group id)
 		void add_arcs_of_network(const int group, std::vector<Arc> arcs);
+		/// Stores a branching constraint on the flow over an arc, new path variables using the arc have to be added to it
+		void add_arc_flow_constraint(ArcFlowConstraint cons);
+		void clear_arc_flow_constraints();
 		/// Stores the part-of relation of a path, i.e. list of arcs, to a generated variable. This is needed to map the LP solution back to its original variables
 		void add_var_path_pair(std::string varname, Path path);
+		/// Removes the path record of a generated variable, e.g. after the variable was deleted from the problem
+		void remove_var_path_pair(const std::string& varname);
+
+		/// Estimated bytes held by each table, including all networks and the store of generated paths
+		memory_usage_t get_memory_usage();
 
 	private:
 		// All constraints relevant to pricing (including a priced variable). Contains a list of arcs for each constraint.
@@ -69,12 +83,17 @@ class DataManager {
 		// All networks that are part of the pricing problem. Networks contain an Edge<->Arc mapping
 		std::mutex networks_mutex_;
 		std::unordered_map<int, Network> networks_;
+		std::vector<Network*> network_list_;
 		// Maps an arc to all constraints it was part of, including the coefficient.
 		std::mutex arc_to_scip_constraints_mutex_;
 		std::unordered_map<Arc, std::vector<constraint_data_t> > arc_to_scip_constraints_;
 		// Map an arc to the network group id it is included in
 		std::mutex arc_to_network_mutex_;
 		std::unordered_map<int, int> arc_to_network_;
+		// Branching constraints on arc flows, and the reverse map from an arc to its branching constraints (coefficients are always one)
+		std::mutex arc_flow_constraints_mutex_;
+		std::vector<ArcFlowConstraint> arc_flow_constraints_;
+		std::unordered_map<Arc, std::vector<constraint_data_t> > arc_to_arc_flow_constraints_;
 		// Map a generated variable to the arcs it represents and the group id of the network it was generated from (for reporting)
 		std::mutex generated_var_to_path_mutex_;
 		std::unordered_map<std::string, Path> generated_var_to_path_;
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "DualTrace.hpp"
+
+#include <assert.h>
+
+#include "logging.hpp"
+
+static const char c_magic[4] = {'H', 'G', 'D', 'T'};
+static const std::uint32_t c_version = 1;
+
+template<typename T>
+static void write_value(std::ofstream& file, T value) {
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+static bool read_value(std::ifstream& file, T& value) {
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+DualTraceWriter::DualTraceWriter(const std::string& filename, const std::vector<std::string>& constraint_names) :
+	file_(filename, std::ios::binary),
+	n_constraints_(constraint_names.size()) {
+	if (!file_) ABORT_F("Unable to open dual trace %s", filename.c_str());
+	file_.write(c_magic, sizeof(c_magic));
+	write_value<std::uint32_t>(file_, c_version);
+	write_value<std::uint32_t>(file_, constraint_names.size());
+	for (const auto &name : constraint_names) {
+		write_value<std::uint32_t>(file_, name.size());
+		file_.write(name.data(), name.size());
+	}
+}
+
+void DualTraceWriter::write(bool farkas, const std::vector<double>& duals) {
+	assert(duals.size() == n_constraints_);
+	std::uint32_t n_nonzero = 0;
+	for (auto dual : duals) if (dual != 0.0) n_nonzero++;
+	write_value<std::uint8_t>(file_, farkas);
+	write_value<std::uint32_t>(file_, n_nonzero);
+	for (std::size_t i = 0; i < duals.size(); i++) {
+		if (duals[i] == 0.0) continue;
+		write_value<std::uint32_t>(file_, i);
+		write_value<double>(file_, duals[i]);
+	}
+	file_.flush();
+}
+
+DualTraceReader::DualTraceReader(const std::string& filename) :
+	file_(filename, std::ios::binary),
+	filename_(filename) {
+	if (!file_) ABORT_F("Unable to open dual trace %s", filename.c_str());
+	char magic[4];
+	std::uint32_t version, n_constraints;
+	if (!file_.read(magic, sizeof(magic)) || std::string(magic, 4) != std::string(c_magic, 4))
+		ABORT_F("%s is not a dual trace", filename.c_str());
+	if (!read_value(file_, version) || version != c_version)
+		ABORT_F("Unsupported dual trace version in %s", filename.c_str());
+	if (!read_value(file_, n_constraints)) ABORT_F("Truncated dual trace header in %s", filename.c_str());
+	constraint_names_.reserve(n_constraints);
+	for (std::uint32_t i = 0; i < n_constraints; i++) {
+		std::uint32_t length;
+		if (!read_value(file_, length)) ABORT_F("Truncated dual trace header in %s", filename.c_str());
+		std::string name(length, '\0');
+		if (!file_.read(&name[0], length)) ABORT_F("Truncated dual trace header in %s", filename.c_str());
+		constraint_names_.push_back(std::move(name));
+	}
+}
+
+bool DualTraceReader::read(bool& farkas, std::vector<double>& duals) {
+	std::uint8_t farkas_flag;
+	std::uint32_t n_nonzero;
+	if (!read_value(file_, farkas_flag)) return false;
+	if (!read_value(file_, n_nonzero)) ABORT_F("Truncated pricing call in dual trace %s", filename_.c_str());
+	farkas = farkas_flag != 0;
+	duals.assign(constraint_names_.size(), 0.0);
+	for (std::uint32_t i = 0; i < n_nonzero; i++) {
+		std::uint32_t index;
+		double value;
+		if (!read_value(file_, index) || !read_value(file_, value) || index >= duals.size())
+			ABORT_F("Corrupt pricing call in dual trace %s", filename_.c_str());
+		duals[index] = value;
+	}
+	return true;
+}
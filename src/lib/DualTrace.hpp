@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __DUALTRACE_HPP
+#define __DUALTRACE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** Binary recording of the dual prices (or Farkas coefficients) of every pricing call
+ * The file starts with the magic "HGDT", a format version and the names of all pricing constraints,
+ * in the order of the data manager. Each pricing call is stored as a farkas flag, the number of nonzero values
+ * and (constraint index, value) pairs. Integers and doubles are written in native byte order.
+ * Replaying a trace only requires the networks and constraint maps of the same instance, not the SCIP LP.
+ */
+class DualTraceWriter {
+	public:
+		DualTraceWriter(const std::string& filename, const std::vector<std::string>& constraint_names);
+
+		/// Appends one pricing call, duals holds one value per constraint in the order of the header
+		void write(bool farkas, const std::vector<double>& duals);
+
+	private:
+		std::ofstream file_;
+		std::size_t n_constraints_;
+};
+
+class DualTraceReader {
+	public:
+		DualTraceReader(const std::string& filename);
+
+		const std::vector<std::string>& get_constraint_names() const { return constraint_names_; }
+		/** Reads the next pricing call
+		 * @param duals is resized to the number of constraints, all values not stored in the trace are zero
+		 * @return false if the end of the trace has been reached
+		 */
+		bool read(bool& farkas, std::vector<double>& duals);
+
+	private:
+		std::ifstream file_;
+		std::string filename_;
+		std::vector<std::string> constraint_names_;
+};
+
+#endif
@@ -22,43 +22,27 @@
 
 #include "FullPricer.hpp"
 
-#include <future>
+#include <atomic>
 
-#include <boost/asio.hpp>
-
-FullPricer::FullPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, boost::asio::thread_pool& tpool) :
+FullPricer::FullPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, TaskPool& tpool) :
 	ObjPricerGFCG(scip, pricer_name, data_manager, tpool) {}
 
-int FullPricer::shortest_path_cg(SCIP * scip) {
-	std::mutex counter_mutex;
-	int n_iteration_generated_paths = 0;
+int FullPricer::select_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column) {
+	std::atomic<int> n_iteration_generated_paths(0);
 
 	DLOG_F(1, "Starting shortest path ...");
-	std::vector<std::future<SCIP_RETCODE>> add_var_futures;
-	std::mutex scip_mutex;
-
-	for (auto &net : data_manager_.get_networks()) {
-        	auto task = std::make_shared<std::packaged_task<SCIP_RETCODE()>> ([&]() {
-        		auto path = net.second.shortest_path();
-			if (SCIPisNegative(scip, path.length)) {
-				LOG_SCOPE_F(2, "Found path with negative length (%f). Adding as variable.", path.length);
+	auto retcode = price_networks([&](const Path& path) {
+		if (SCIPisNegative(scip, path.length)) {
+			LOG_SCOPE_F(2, "Found path with negative length (%f). Adding as variable.", path.length);
 
-				generate_columns(scip, path, scip_mutex);
+			SCIP_CALL( add_column(path) );
 
-				counter_mutex.lock();
-				n_iteration_generated_paths++;
-				n_generated_paths_++;
-				counter_mutex.unlock();
-				return SCIP_OKAY;
-			}
-			return SCIP_OKAY;
-		});
-		add_var_futures.push_back(std::move(task->get_future()));
-		boost::asio::post(tpool_, std::bind(&std::packaged_task<SCIP_RETCODE()>::operator(), task));
-	}
-	for (auto& future : add_var_futures)
-		if (future.get() != SCIP_OKAY) ABORT_F("SCIP reported an error during the variable generation routine");
+			n_iteration_generated_paths++;
+		}
+		return SCIP_OKAY;
+	});
+	if (retcode != SCIP_OKAY) ABORT_F("SCIP reported an error during the variable generation routine");
 
-	LOG_F(1, "Completed pricing, generated %d new paths/variables", n_iteration_generated_paths);
+	LOG_F(1, "Completed pricing, generated %d new paths/variables", n_iteration_generated_paths.load());
 	return n_iteration_generated_paths;
 }
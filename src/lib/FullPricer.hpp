@@ -26,19 +26,19 @@
 #include <string>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <objscip/objscip.h>
 
 #include "ObjPricerGFCG.hpp"
 #include "DataManager.hpp"
+#include "TaskPool.hpp"
 
 /** Derived pricer class that adds all negative-length paths as variables */
 class FullPricer : public ObjPricerGFCG {
 	public:
-		FullPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, boost::asio::thread_pool& tpool);
+		FullPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, TaskPool& tpool);
 
 	private:
-		int shortest_path_cg(SCIP * scip);
+		int select_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column) override;
 };
 
 #endif
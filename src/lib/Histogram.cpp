@@ -0,0 +1,99 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Histogram::Histogram() {
+	clear();
+}
+
+/** Values below c_sub_buckets get a bucket of their own, larger values are identified by the position of their
+ * most significant bit and the c_sub_bucket_bits bits following it.
+ */
+int Histogram::bucket_of(std::uint64_t value) {
+	if (value < c_sub_buckets) return value;
+	int msb = 63 - __builtin_clzll(value);
+	int sub_bucket = (value >> (msb - c_sub_bucket_bits)) & (c_sub_buckets - 1);
+	return (msb - c_sub_bucket_bits + 1) * c_sub_buckets + sub_bucket;
+}
+
+std::uint64_t Histogram::bucket_upper_bound(int bucket) {
+	if (bucket < c_sub_buckets) return bucket;
+	int shift = bucket / c_sub_buckets - 1;
+	std::uint64_t lower = static_cast<std::uint64_t>(c_sub_buckets + bucket % c_sub_buckets) << shift;
+	return lower + ((std::uint64_t(1) << shift) - 1);
+}
+
+void Histogram::record(std::uint64_t value) {
+	counts_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+	count_.fetch_add(1, std::memory_order_relaxed);
+	sum_.fetch_add(value, std::memory_order_relaxed);
+	auto max = max_.load(std::memory_order_relaxed);
+	while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+void Histogram::add(const Histogram& other) {
+	for (int i = 0; i < c_buckets; i++) counts_[i] += other.counts_[i].load();
+	count_ += other.count_.load();
+	sum_ += other.sum_.load();
+	if (other.max_.load() > max_.load()) max_ = other.max_.load();
+}
+
+void Histogram::clear() {
+	for (auto &count : counts_) count = 0;
+	count_ = 0;
+	sum_ = 0;
+	max_ = 0;
+}
+
+std::uint64_t Histogram::get_count() const {
+	return count_;
+}
+
+std::uint64_t Histogram::get_max() const {
+	return max_;
+}
+
+std::uint64_t Histogram::get_sum() const {
+	return sum_;
+}
+
+double Histogram::get_mean() const {
+	return count_ > 0 ? static_cast<double>(sum_) / count_ : 0.0;
+}
+
+std::uint64_t Histogram::get_percentile(double percentile) const {
+	if (count_ == 0) return 0;
+	// rank of the requested value among all recorded values, starting at one
+	auto rank = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count_));
+	if (rank < 1) rank = 1;
+	std::uint64_t seen = 0;
+	for (int i = 0; i < c_buckets; i++) {
+		seen += counts_[i];
+		// the exact maximum is known, which is a tighter bound for the last bucket
+		if (seen >= rank) return std::min(bucket_upper_bound(i), get_max());
+	}
+	return get_max();
+}
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __HISTOGRAM_HPP
+#define __HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/** Log-linear histogram of non-negative integer values (HDR style)
+ * Every power of two is split into eight linear sub-buckets, so any recorded value
+ * is reported with a relative error below 12.5% while the whole 64 bit range fits into 496 buckets.
+ * Recording is lock-free and may happen concurrently, reading and clearing should only happen while no values are recorded.
+ */
+class Histogram {
+	public:
+		Histogram();
+
+		void record(std::uint64_t value);
+		/// Adds all values recorded by another histogram
+		void add(const Histogram& other);
+		void clear();
+
+		std::uint64_t get_count() const;
+		std::uint64_t get_max() const;
+		std::uint64_t get_sum() const;
+		double get_mean() const;
+		/// Upper bound of the bucket containing the given percentile (0 to 100) of the recorded values, 0 if empty
+		std::uint64_t get_percentile(double percentile) const;
+
+	private:
+		static const int c_sub_bucket_bits = 3;
+		static const int c_sub_buckets = 1 << c_sub_bucket_bits;
+		static const int c_buckets = (64 - c_sub_bucket_bits + 1) * c_sub_buckets;
+
+		static int bucket_of(std::uint64_t value);
+		static std::uint64_t bucket_upper_bound(int bucket);
+
+		std::array<std::atomic<std::uint64_t>, c_buckets> counts_;
+		std::atomic<std::uint64_t> count_;
+		std::atomic<std::uint64_t> sum_;
+		std::atomic<std::uint64_t> max_;
+};
+
+#endif
@@ -22,70 +22,48 @@
 
 #include "KShortestPricer.hpp"
 
+#include <algorithm>
 #include <assert.h>
-#include <future>
+#include <atomic>
 
-#include <boost/asio.hpp>
-#include "loguru.hpp"
+#include "logging.hpp"
 
 #include "Path.hpp"
+#include "TopKPaths.hpp"
 
-KShortestPricer::KShortestPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, boost::asio::thread_pool& tpool, int k) :
+KShortestPricer::KShortestPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, TaskPool& tpool, int k) :
 	ObjPricerGFCG(scip, pricer_name, data_manager, tpool),
 	k_(k) {
 	assert(k_ > 0);
 }
 
-int KShortestPricer::shortest_path_cg(SCIP * scip) {
-	std::mutex scip_mutex;
-	std::mutex counter_mutex;
-	int iteration_generated_paths = 0;
-
-	DLOG_F(1, "Starting shortest path ...");
-	std::vector<std::future<Path>> path_futures;
-	for (auto &net : data_manager_.get_networks()) {
-		auto task = std::make_shared<std::packaged_task<Path()>> (std::bind(&Network::shortest_path, std::ref(net.second)));
-		path_futures.push_back(std::move(task->get_future()));
-		boost::asio::post(tpool_, std::bind(&std::packaged_task<Path()>::operator(), task));
-	}
-	std::vector<Path> negative_length_paths;
-	for (auto& future : path_futures) {
-		auto path = future.get();
-		if (SCIPisNegative(scip, path.length)) negative_length_paths.push_back(std::move(path));
-	}
-
-	DLOG_F(1, "Apply pricing strategy ...");
+/** Computes the shortest path of every network and selects the k shortest negative ones as columns
+ * If recent paths were priced first in this iteration, only the rest of the k columns is selected (see column_budget_).
+ * Networks report their result to a bounded selection as soon as they finish.
+ * Paths that are guaranteed to stay among the k best are passed to add_column right away by the reporting worker,
+ * so there is no barrier between the shortest path computation and the insertion of new variables.
+ */
+int KShortestPricer::select_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column) {
+	std::atomic<int> iteration_generated_paths(0);
 
-	if (k_ < negative_length_paths.size()) {
-		DLOG_F(3, "Sort ...");
-		std::sort(negative_length_paths.begin(), negative_length_paths.end());
-		DLOG_F(3, "Erase ...");
-		negative_length_paths.erase(negative_length_paths.begin() + k_, negative_length_paths.end());
-	}
+	TopKPaths selection(column_budget_ > 0 ? std::min(k_, column_budget_) : k_, data_manager_.get_network_list().size());
 
-	DLOG_F(1, "Adding new variables ...");
-	std::vector<std::future<SCIP_RETCODE>> add_var_futures;
-	for (const auto& path : negative_length_paths) {
-		auto net = data_manager_.get_network(path.network_group);
+	DLOG_F(1, "Starting shortest path and streaming selection ...");
+	auto retcode = price_networks([&](const Path& path) {
+		auto winners = SCIPisNegative(scip, path.length) ? selection.push(path) : selection.skip();
 
-		auto task = std::make_shared<std::packaged_task<SCIP_RETCODE()>> ([&]() {
-			// add path as variable to master lp if it satisfies the condition
-			if (!SCIPisNegative(scip, path.length)) return SCIP_OKAY;
-			LOG_SCOPE_F(2, "Found path with negative length (%f). Adding as variable.", path.length);
+		// add all paths which are certain to be among the k shortest
+		for (auto& winner : winners) {
+			LOG_SCOPE_F(2, "Found path with negative length (%f). Adding as variable.", winner.length);
 
-			generate_columns(scip, path, scip_mutex);
+			SCIP_CALL( add_column(std::move(winner)) );
 
-			counter_mutex.lock();
 			iteration_generated_paths++;
-			n_generated_paths_++;
-			counter_mutex.unlock();
-			return SCIP_OKAY;
-		});
-		add_var_futures.push_back(std::move(task->get_future()));
-		boost::asio::post(tpool_, std::bind(&std::packaged_task<SCIP_RETCODE()>::operator(), task));
-	}
-	for (auto& future : add_var_futures)
-		if (future.get() != SCIP_OKAY) ABORT_F("SCIP reported an error during the variable generation routine");
+		}
+		return SCIP_OKAY;
+	});
+	if (retcode != SCIP_OKAY) ABORT_F("SCIP reported an error during the variable generation routine");
 
+	assert(selection.get_confirmed_count() == iteration_generated_paths);
 	return iteration_generated_paths;
 }
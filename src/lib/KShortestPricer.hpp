@@ -26,21 +26,22 @@
 #include <string>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <objscip/objscip.h>
 
 #include "ObjPricerGFCG.hpp"
 #include "DataManager.hpp"
+#include "TaskPool.hpp"
 
 /** Derived pricer class that adds only the k shortest negative-length paths as variables */
 class KShortestPricer : public ObjPricerGFCG {
 	public:
-		KShortestPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, boost::asio::thread_pool& tpool, int k);
+		KShortestPricer(SCIP * scip, const std::string pricer_name, DataManager& data_manager, TaskPool& tpool, int k);
 
 	private:
 		int k_;
 
-		int shortest_path_cg(SCIP * scip);
+		int select_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column) override;
+		int get_column_limit() const override { return k_; }
 };
 
 #endif
@@ -22,15 +22,47 @@
 
 #include "Network.hpp"
 
-#include <tuple>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
 
-#include <boost/graph/dag_shortest_paths.hpp>
-#include <boost/graph/adjacency_list.hpp>
+#include <boost/container_hash/hash.hpp>
+
+#include "TaskPool.hpp"
+#include "memory_usage.hpp"
 
 using boost::property_tree::ptree;
 
+bool NetworkTopology::operator==(const NetworkTopology& rhs) const {
+	return source == rhs.source && sink == rhs.sink && in_offsets == rhs.in_offsets && in_sources == rhs.in_sources;
+}
+
+std::size_t NetworkTopology::hash() const {
+	std::size_t seed = 0;
+	boost::hash_combine(seed, source);
+	boost::hash_combine(seed, sink);
+	boost::hash_range(seed, in_offsets.begin(), in_offsets.end());
+	boost::hash_range(seed, in_sources.begin(), in_sources.end());
+	return seed;
+}
+
+std::size_t NetworkTopology::get_bytes() const {
+	return vector_bytes(in_offsets) + vector_bytes(in_sources) + vector_bytes(level_offsets);
+}
+
+void ShortestPathScratch::reserve(std::size_t n_vertices) {
+	if (distance.size() >= n_vertices) return;
+	distance.resize(n_vertices);
+	pred_edge.resize(n_vertices);
+}
+
 Network::Network(const std::string &filename, std::vector<Arc>& arc_list) {
 	shortest_path_is_fresh_ = false;
+	keep_swept_weights_ = false;
+	swept_length_ = std::numeric_limits<double>::quiet_NaN();
+	keep_recent_paths_ = false;
+	next_recent_path_ = 0;
 	// Source and sink flags in order to recognize if no source/sink was found
 	bool has_source = false;
 	bool has_sink = false;
@@ -49,11 +81,19 @@ Network::Network(const std::string &filename, std::vector<Arc>& arc_list) {
 	// Parse the XML into the property tree.
 	read_xml(filename, pt);
 
+	// vertices in file order, external node id to vertex, nodes of the vertices, edges in file order
+	std::uint32_t n_vertices = 0;
+	std::uint32_t source_vertex = 0;
+	std::uint32_t sink_vertex = 0;
+	std::map<int, std::uint32_t> id_map;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+	std::vector<Node> nodes;
+
 	// TODO templating should be implemented here (with config file)
 	// descend to graphml.graph where nodes and edges are stored and iterate over them
 	for (const auto &elem : pt.get_child("graphml.graph")) {
 		if(elem.first == "node") {
-			auto v = add_vertex(graph_);
+			auto v = n_vertices++;
 
 			int k0, k1, k2, k3, k4, k6;
 			bool k5;
@@ -90,140 +130,652 @@ Network::Network(const std::string &filename, std::vector<Arc>& arc_list) {
 			}
 
 			Node node{k0, k1, k2, k3, k4, k5, k6};
+			nodes.push_back(node);
 
-			// save the external node id to vertex descriptor mapping for creating edges later on
-			id_map_.insert(std::make_pair(elem.second.get<int>("<xmlattr>.id"), std::make_pair(v, node)));
+			// save the external node id to vertex mapping for creating edges later on
+			id_map.insert(std::make_pair(elem.second.get<int>("<xmlattr>.id"), v));
 
 			// check if this is a source or target vertex
 			if (k0 == 0 && k1 == 0 && k3 == -1 && k4 == 0 && !k5) {
 				if (k2 == -2) {
 					if (has_source) ABORT_F("Graph contains more than one source vertex: %s", filename.c_str());
 					has_source = true;
-					source_ = v;
+					source_vertex = v;
 				} else if (k2 == 35) {
 					if (has_sink) ABORT_F("Graph contains more than one sink vertex: %s", filename.c_str());
 					has_sink = true;
-					sink_ = v;
+					sink_vertex = v;
 				}
 			}
 		}
 		if (elem.first == "edge") {
 			auto source_id = elem.second.get<int>("<xmlattr>.source");
-			auto source_res = id_map_.find(source_id);
-			if (!source_res->first) ABORT_F("Graph XML (%s) contains an edge without corresponding source or edge was defined before vertices, source vertex id: %i",
+			auto source_res = id_map.find(source_id);
+			if (source_res == id_map.end()) ABORT_F("Graph XML (%s) contains an edge without corresponding source or edge was defined before vertices, source vertex id: %i",
 					filename.c_str(), source_id);
-			auto source_vertex = source_res->second.first;
-			auto source_node = source_res->second.second;
 
 			auto target_id = elem.second.get<int>("<xmlattr>.target");
-			auto target_res = id_map_.find(target_id);
-			if (!target_res->first) ABORT_F("Graph XML (%s) contains an edge without corresponding target or edge was defined before vertices, target vertex id: %i",
+			auto target_res = id_map.find(target_id);
+			if (target_res == id_map.end()) ABORT_F("Graph XML (%s) contains an edge without corresponding target or edge was defined before vertices, target vertex id: %i",
 					filename.c_str(), target_id);
-			auto target_vertex = target_res->second.first;
-			auto target_node = target_res->second.second;
-
-			add_edge(source_vertex, target_vertex, 0, graph_);
 
-			Arc arc{source_node, target_node};
-			Edge e{source_vertex, target_vertex};
-
-			arc_to_edge_map_.insert(std::make_pair(arc, e));
-			edge_to_arc_map_.insert(std::make_pair(e, arc));
+			Arc arc{nodes[source_res->second], nodes[target_res->second]};
+			edges.push_back(std::make_pair(source_res->second, target_res->second));
 			arc_list.push_back(arc);
 		}
 	}
 	if (!has_source || !has_sink) ABORT_F("Graph is missing source or sink vertex: %s", filename.c_str());
+
+	std::vector<std::uint32_t> position;
+	std::vector<std::uint32_t> edge_index;
+	topology_ = build_topology(n_vertices, edges, source_vertex, sink_vertex, position, edge_index);
+	if (!topology_) ABORT_F("Graph contains a cycle: %s", filename.c_str());
+	weights_.assign(edges.size(), 0);
+
+	// states and time slices of the vertices
+	vertex_states_.resize(n_vertices);
+	vertex_slices_.resize(n_vertices);
+	for (std::uint32_t v = 0; v < n_vertices; v++) {
+		Node state = nodes[v];
+		state.zeitscheibe = 0;
+		auto state_res = state_index_.insert(std::make_pair(state, (std::uint32_t) states_.size()));
+		if (state_res.second) states_.push_back(state);
+		vertex_states_[position[v]] = state_res.first->second;
+		vertex_slices_[position[v]] = nodes[v].zeitscheibe;
+	}
+	index_states();
+}
+
+std::shared_ptr<NetworkTopology> Network::build_topology(std::uint32_t n_vertices, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges,
+		std::uint32_t source, std::uint32_t sink, std::vector<std::uint32_t>& position, std::vector<std::uint32_t>& edge_index) {
+	auto topology = std::make_shared<NetworkTopology>();
+
+	// topological order (Kahn) by level, the vertices of one level are numbered consecutively in input order
+	std::vector<std::uint32_t> out_degree_offsets(n_vertices + 1, 0);
+	std::vector<std::uint32_t> in_degree(n_vertices, 0);
+	for (const auto &edge : edges) {
+		out_degree_offsets[edge.first + 1]++;
+		in_degree[edge.second]++;
+	}
+	for (std::uint32_t v = 0; v < n_vertices; v++) out_degree_offsets[v + 1] += out_degree_offsets[v];
+	std::vector<std::uint32_t> out_targets(edges.size());
+	{
+		auto next = out_degree_offsets;
+		for (const auto &edge : edges) out_targets[next[edge.first]++] = edge.second;
+	}
+	position.assign(n_vertices, 0);
+	std::vector<std::uint32_t> level;
+	for (std::uint32_t v = 0; v < n_vertices; v++)
+		if (in_degree[v] == 0) level.push_back(v);
+	std::uint32_t n_sorted = 0;
+	topology->level_offsets.push_back(0);
+	while (!level.empty()) {
+		std::sort(level.begin(), level.end());
+		std::vector<std::uint32_t> next_level;
+		for (auto v : level) {
+			position[v] = n_sorted++;
+			for (auto i = out_degree_offsets[v]; i < out_degree_offsets[v + 1]; i++)
+				if (--in_degree[out_targets[i]] == 0) next_level.push_back(out_targets[i]);
+		}
+		topology->level_offsets.push_back(n_sorted);
+		level = std::move(next_level);
+	}
+	if (n_sorted != n_vertices) return nullptr;
+	topology->source = position[source];
+	topology->sink = position[sink];
+
+	// in-edges grouped by target in topological order, keeping the input order within a target
+	topology->in_offsets.assign(n_vertices + 1, 0);
+	for (const auto &edge : edges) topology->in_offsets[position[edge.second] + 1]++;
+	for (std::uint32_t v = 0; v < n_vertices; v++) topology->in_offsets[v + 1] += topology->in_offsets[v];
+	topology->in_sources.resize(edges.size());
+	edge_index.resize(edges.size());
+	auto next = topology->in_offsets;
+	for (std::size_t i = 0; i < edges.size(); i++) {
+		auto e = next[position[edges[i].second]]++;
+		topology->in_sources[e] = position[edges[i].first];
+		edge_index[i] = e;
+	}
+	return topology;
+}
+
+/** The vertices of a state are sorted by time slice, in vertex order on ties */
+void Network::index_states() {
+	std::uint32_t n_vertices = vertex_states_.size();
+	state_offsets_.assign(states_.size() + 1, 0);
+	for (auto state : vertex_states_) state_offsets_[state + 1]++;
+	for (std::size_t s = 0; s < states_.size(); s++) state_offsets_[s + 1] += state_offsets_[s];
+	state_vertices_.resize(n_vertices);
+	auto next_vertex = state_offsets_;
+	for (std::uint32_t v = 0; v < n_vertices; v++) state_vertices_[next_vertex[vertex_states_[v]]++] = v;
+	for (std::size_t s = 0; s < states_.size(); s++) {
+		std::stable_sort(state_vertices_.begin() + state_offsets_[s], state_vertices_.begin() + state_offsets_[s + 1],
+				[this](std::uint32_t a, std::uint32_t b) { return vertex_slices_[a] < vertex_slices_[b]; });
+	}
+}
+
+/** Vertices off every source-sink path are removed. A vertex with exactly one in-edge and one out-edge, both without weight,
+ * is removed by contracting the two edges into one, so chains of unweighted edges become a single edge.
+ * The removed vertices keep their nodes (numbered after the vertices of the topology), so arcs into or out of them are still recognized:
+ * weight changes of contracted arcs apply to the edge containing them, arcs of removed dead vertices are ignored.
+ */
+Network::ReductionStats Network::reduce(const std::function<bool(const Arc&)>& is_weighted) {
+	const auto& topology = *topology_;
+	std::uint32_t n_vertices = get_vertex_count();
+	std::uint32_t n_edges = get_edge_count();
+	ReductionStats stats{n_vertices, n_edges, 0, 0};
+
+	// edges in current numbering, with their original arcs (a contracted edge spans the vertices of its expansion)
+	std::vector<std::uint32_t> edge_targets(n_edges);
+	for (std::uint32_t v = 0; v < n_vertices; v++)
+		for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) edge_targets[e] = v;
+	auto edge_weighted = [&](std::uint32_t e) {
+		if (has_expansion(e)) return false;
+		return is_weighted(Arc{get_node(topology.in_sources[e]), get_node(edge_targets[e])});
+	};
+
+	// vertices on a source-sink path: reachable from the source and reaching the sink, the vertex order is topological
+	std::vector<bool> from_source(n_vertices, false);
+	std::vector<bool> to_sink(n_vertices, false);
+	from_source[topology.source] = true;
+	to_sink[topology.sink] = true;
+	for (std::uint32_t v = 0; v < n_vertices; v++)
+		for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1] && !from_source[v]; e++)
+			from_source[v] = from_source[topology.in_sources[e]];
+	for (std::uint32_t v = n_vertices; v-- > 0;)
+		if (to_sink[v]) for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) to_sink[topology.in_sources[e]] = true;
+	auto live = [&](std::uint32_t v) { return from_source[v] && to_sink[v]; };
+
+	// the single live in- and out-edge of vertices which may be contracted
+	std::vector<std::uint32_t> live_in_edge(n_vertices, c_no_edge);
+	std::vector<std::uint32_t> live_out_edge(n_vertices, c_no_edge);
+	std::vector<std::uint32_t> live_in_degree(n_vertices, 0);
+	std::vector<std::uint32_t> live_out_degree(n_vertices, 0);
+	for (std::uint32_t e = 0; e < n_edges; e++) {
+		auto u = topology.in_sources[e];
+		auto v = edge_targets[e];
+		if (!live(u) || !live(v)) continue;
+		live_out_degree[u]++;
+		live_out_edge[u] = e;
+		live_in_degree[v]++;
+		live_in_edge[v] = e;
+	}
+	std::vector<bool> interior(n_vertices, false);
+	for (std::uint32_t v = 0; v < n_vertices; v++) {
+		if (!live(v) || v == topology.source || v == topology.sink) continue;
+		if (live_in_degree[v] != 1 || live_out_degree[v] != 1) continue;
+		interior[v] = !edge_weighted(live_in_edge[v]) && !edge_weighted(live_out_edge[v]);
+	}
+
+	// kept vertices in current order, then the removed ones
+	std::vector<std::uint32_t> kept_index(n_vertices, c_no_vertex);
+	std::uint32_t n_kept = 0;
+	for (std::uint32_t v = 0; v < n_vertices; v++)
+		if (live(v) && !interior[v]) kept_index[v] = n_kept++;
+	if (n_kept == n_vertices) {
+		stats.vertices_after = n_vertices;
+		stats.edges_after = n_edges;
+		return stats;
+	}
+
+	// every live edge out of a kept vertex starts a new edge, following contracted vertices to the next kept one
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+	std::vector<std::vector<std::uint32_t>> expansions;
+	for (std::uint32_t e = 0; e < n_edges; e++) {
+		auto u = topology.in_sources[e];
+		auto v = edge_targets[e];
+		if (kept_index[u] == c_no_vertex || !live(v)) continue;
+		std::vector<std::uint32_t> expansion;
+		// the expansions of contracted edges contribute their vertices too
+		auto expand = [&](std::uint32_t edge) {
+			if (!has_expansion(edge)) return;
+			expansion.insert(expansion.end(), expansion_vertices_.begin() + expansion_offsets_[edge], expansion_vertices_.begin() + expansion_offsets_[edge + 1]);
+		};
+		expand(e);
+		while (interior[v]) {
+			expansion.push_back(v);
+			auto next = live_out_edge[v];
+			expand(next);
+			v = edge_targets[next];
+		}
+		edges.push_back(std::make_pair(kept_index[u], kept_index[v]));
+		expansions.push_back(std::move(expansion));
+	}
+
+	std::vector<std::uint32_t> position;
+	std::vector<std::uint32_t> edge_index;
+	auto reduced = build_topology(n_kept, edges, kept_index[topology.source], kept_index[topology.sink], position, edge_index);
+	assert(reduced);
+
+	// new vertex numbers: topology vertices, then all removed vertices (current removed ones and those of earlier reductions)
+	std::uint32_t n_all = vertex_states_.size();
+	std::vector<std::uint32_t> renumber(n_all);
+	std::uint32_t next_removed = n_kept;
+	for (std::uint32_t v = 0; v < n_all; v++) {
+		if (v < n_vertices && kept_index[v] != c_no_vertex) renumber[v] = position[kept_index[v]];
+		else renumber[v] = next_removed++;
+	}
+	std::vector<std::uint32_t> vertex_states(n_all);
+	std::vector<int> vertex_slices(n_all);
+	for (std::uint32_t v = 0; v < n_all; v++) {
+		vertex_states[renumber[v]] = vertex_states_[v];
+		vertex_slices[renumber[v]] = vertex_slices_[v];
+	}
+
+	std::vector<std::uint32_t> expansion_offsets(edges.size() + 1, 0);
+	for (std::size_t i = 0; i < edges.size(); i++) expansion_offsets[edge_index[i] + 1] = expansions[i].size();
+	for (std::size_t e = 0; e < edges.size(); e++) expansion_offsets[e + 1] += expansion_offsets[e];
+	std::vector<std::uint32_t> expansion_vertices(expansion_offsets.back());
+	// the contracted edge of removed vertices, c_no_edge for vertices off every source-sink path
+	std::vector<std::uint32_t> removed_vertex_edges(n_all - n_kept, c_no_edge);
+	for (std::size_t i = 0; i < edges.size(); i++) {
+		auto offset = expansion_offsets[edge_index[i]];
+		for (auto v : expansions[i]) {
+			expansion_vertices[offset++] = renumber[v];
+			removed_vertex_edges[renumber[v] - n_kept] = edge_index[i];
+		}
+	}
+
+	topology_ = std::move(reduced);
+	weights_.assign(edges.size(), 0);
+	swept_weights_.clear();
+	swept_length_ = std::numeric_limits<double>::quiet_NaN();
+	recent_paths_.clear();
+	next_recent_path_ = 0;
+	vertex_states_ = std::move(vertex_states);
+	vertex_slices_ = std::move(vertex_slices);
+	expansion_offsets_ = std::move(expansion_offsets);
+	expansion_vertices_ = std::move(expansion_vertices);
+	removed_vertex_edges_ = std::move(removed_vertex_edges);
+	index_states();
+	shortest_path_is_fresh_ = false;
+	stats.vertices_after = n_kept;
+	stats.edges_after = edges.size();
+	return stats;
 }
 
 Path Network::shortest_path() {
-	//const std::lock_guard<std::mutex> lock(graph_mutex_);
-	if (shortest_path_is_fresh_) return shortest_path_;
-
-	// https://www.boost.org/doc/libs/1_72_0/libs/graph/example/dag_shortest_paths.cpp
-	distance_map_t d_map = get(boost::vertex_distance, graph_);
-	boost::property_map<dag_t, boost::edge_weight_t>::type w_map = boost::get(boost::edge_weight, graph_);
-	std::vector<boost::default_color_type> color(num_vertices(graph_));
-	std::vector<std::size_t> pred(boost::num_vertices(graph_));
-  	boost::default_dijkstra_visitor vis;
-	std::less<double> compare;
-	boost::closed_plus<double> combine;
-	// O(V + E)
-	boost::dag_shortest_paths(graph_, source_, d_map, w_map, color.data(), pred.data(), vis, compare, combine, (std::numeric_limits<int>::max)(), 0);
-
-	// build path
-	// TODO config option to skip this if length non negative
-	std::vector<Arc> shortest_path_arcs;
-	auto v = sink_;
-	while (v != source_) {
-		auto result = boost::edge(pred[v], v, graph_);
-		assert(result.second);
-		auto edge_descriptor = result.first;
-		Edge edge = {boost::source(edge_descriptor, graph_), boost::target(edge_descriptor, graph_)};
-		auto arc_res = edge_to_arc_map_.find(edge);
-		if (arc_res == edge_to_arc_map_.end()) ABORT_F("Shortest path contained an edge without corresponding arc, network group: %i", group_);
-		shortest_path_arcs.push_back(arc_res->second);
-		v = pred[v];
-	}
-	Path p{d_map[sink_], shortest_path_arcs, group_};
-	shortest_path_ = p;
+	thread_local ShortestPathScratch s_scratch;
+	return shortest_path(s_scratch);
+}
+
+/** DAG shortest path in O(V + E), pulling the distance of every vertex from its in-edges in topological order
+ * Vertices before the source in the order can not be reached from it. Edges out of unreached vertices and forbidden edges,
+ * which both carry the infinite distance/weight DBL_MAX, are never relaxed.
+ */
+const Path& Network::shortest_path(ShortestPathScratch& scratch) {
+	if (!init_sweep(scratch)) return shortest_path_;
+	relax(topology_->source + 1, get_vertex_count(), scratch.distance.data(), scratch.pred_edge.data());
+	return store_shortest_path(scratch.distance.data(), scratch.pred_edge.data(), 1);
+}
+
+const Path& Network::shortest_path(ShortestPathScratch& scratch, TaskPool& tpool) {
+	if (!init_sweep(scratch)) return shortest_path_;
+	const auto& topology = *topology_;
+	double* distance = scratch.distance.data();
+	std::uint32_t* pred_edge = scratch.pred_edge.data();
+	for (std::size_t l = 0; l + 1 < topology.level_offsets.size(); l++) {
+		std::uint32_t begin = std::max(topology.level_offsets[l], topology.source + 1);
+		std::uint32_t end = topology.level_offsets[l + 1];
+		if (begin >= end) continue;
+		if (end - begin < c_min_parallel_level) {
+			relax(begin, end, distance, pred_edge);
+			continue;
+		}
+		std::uint32_t chunk = (end - begin + tpool.get_thread_count() - 1) / tpool.get_thread_count();
+		std::uint32_t n_chunks = (end - begin + chunk - 1) / chunk;
+		tpool.parallel_for("shortest_path_level", n_chunks, [&](std::size_t c) {
+			relax(begin + c * chunk, std::min(end, begin + (std::uint32_t) (c + 1) * chunk), distance, pred_edge);
+		}, 1);
+	}
+	return store_shortest_path(scratch.distance.data(), scratch.pred_edge.data(), 1);
+}
+
+void Network::relax(std::uint32_t begin, std::uint32_t end, double* distance, std::uint32_t* pred_edge) const {
+	const auto& topology = *topology_;
+	const double infinity = (std::numeric_limits<double>::max)();
+	for (std::uint32_t v = begin; v < end; v++) {
+		double best = infinity;
+		std::uint32_t best_edge = c_no_edge;
+		for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) {
+			double d = distance[topology.in_sources[e]];
+			double w = weights_[e];
+			if (d == infinity || w == infinity) continue;
+			if (d + w < best) {
+				best = d + w;
+				best_edge = e;
+			}
+		}
+		distance[v] = best;
+		pred_edge[v] = best_edge;
+	}
+}
+
+bool Network::init_sweep(ShortestPathScratch& scratch) {
+	if (shortest_path_is_fresh_) return false;
+	std::uint32_t n_vertices = get_vertex_count();
+	scratch.reserve(n_vertices);
+	std::fill_n(scratch.distance.data(), n_vertices, (std::numeric_limits<double>::max)());
+	scratch.distance[topology_->source] = 0;
+	scratch.pred_edge[topology_->source] = c_no_edge;
+	return true;
+}
+
+template<typename E>
+const Path& Network::store_shortest_path(const double* distance, const E* pred_edge, std::size_t stride) {
+	const auto& topology = *topology_;
+	shortest_path_.network_group = group_;
+	shortest_path_.arcs.clear();
 	shortest_path_is_fresh_ = true;
-	return p;
+	if (keep_swept_weights_) {
+		swept_weights_ = weights_;
+		swept_length_ = (distance[topology.sink * stride] == (std::numeric_limits<double>::max)())
+			? std::numeric_limits<double>::infinity() : distance[topology.sink * stride];
+	}
+	// the sink may be unreachable if edges were forbidden
+	if (distance[topology.sink * stride] == (std::numeric_limits<double>::max)()) {
+		shortest_path_.length = std::numeric_limits<double>::infinity();
+		return shortest_path_;
+	}
+
+	// TODO config option to skip this if length non negative
+	shortest_path_.length = distance[topology.sink * stride];
+	path_edges_.clear();
+	for (auto v = topology.sink; v != topology.source; v = topology.in_sources[pred_edge[v * stride]]) {
+		append_arcs(pred_edge[v * stride], v, shortest_path_.arcs);
+		path_edges_.push_back(pred_edge[v * stride]);
+	}
+	if (keep_recent_paths_ && std::find(recent_paths_.begin(), recent_paths_.end(), path_edges_) == recent_paths_.end()) {
+		// the oldest path is replaced, its buffer reused
+		if (recent_paths_.size() < c_recent_paths) recent_paths_.push_back(path_edges_);
+		else recent_paths_[next_recent_path_] = path_edges_;
+		next_recent_path_ = (next_recent_path_ + 1) % c_recent_paths;
+	}
+	return shortest_path_;
+}
+
+template const Path& Network::store_shortest_path(const double* distance, const std::uint32_t* pred_edge, std::size_t stride);
+template const Path& Network::store_shortest_path(const double* distance, const std::uint64_t* pred_edge, std::size_t stride);
+
+namespace {
+	/// Minimum of zero and value(i) for i in [begin, end), with independent accumulators to hide the latency of the comparisons
+	template<typename F>
+	double min_negative(std::uint32_t begin, std::uint32_t end, F value) {
+		double minimum[4] = {0, 0, 0, 0};
+		auto i = begin;
+		for (; i + 4 <= end; i += 4) {
+			for (int j = 0; j < 4; j++) {
+				double v = value(i + j);
+				minimum[j] = (v < minimum[j]) ? v : minimum[j];
+			}
+		}
+		for (; i < end; i++) minimum[0] = std::min(minimum[0], value(i));
+		return std::min(std::min(minimum[0], minimum[1]), std::min(minimum[2], minimum[3]));
+	}
+}
+
+/** Edges always lead to a higher level, so a path has at most one edge into every level. Two bounds follow:
+ * the sum of the minimal negative in-edge weight of every level, and the shortest path length of the last sweep
+ * plus the sum of the minimal negative weight change per level since then. The second is tight if few weights changed,
+ * as in the late iterations of column generation. Forbidden edges have the weight DBL_MAX and never lower the level bound.
+ * An edge forbidden at the last sweep and allowed again changes by about -DBL_MAX, which makes the change bound useless but keeps it sound.
+ */
+double Network::length_bound() {
+	if (shortest_path_is_fresh_) return shortest_path_.length;
+	const auto& topology = *topology_;
+	// an unreachable sink may become reachable by lifting forbidden edges, which the change bound does not capture
+	bool use_change = keep_swept_weights_ && !std::isnan(swept_length_) && !std::isinf(swept_length_);
+	keep_swept_weights_ = true;
+	double level_bound = 0;
+	double change_bound = use_change ? swept_length_ : 0;
+	for (std::size_t l = 1; l + 1 < topology.level_offsets.size(); l++) {
+		auto begin = topology.in_offsets[topology.level_offsets[l]];
+		auto end = topology.in_offsets[topology.level_offsets[l + 1]];
+		level_bound += min_negative(begin, end, [&](std::uint32_t e) { return weights_[e]; });
+		if (use_change) change_bound += min_negative(begin, end, [&](std::uint32_t e) { return weights_[e] - swept_weights_[e]; });
+	}
+	return use_change ? std::max(level_bound, change_bound) : level_bound;
+}
+
+const Path* Network::shortest_recent_path() {
+	keep_recent_paths_ = true;
+	if (shortest_path_is_fresh_) return &shortest_path_;
+	const double infinity = (std::numeric_limits<double>::max)();
+	const std::vector<std::uint32_t>* best = nullptr;
+	double best_length = std::numeric_limits<double>::infinity();
+	for (const auto& edges : recent_paths_) {
+		double length = 0;
+		for (auto e : edges) {
+			// paths over forbidden edges are no candidates
+			if (weights_[e] == infinity) {
+				length = std::numeric_limits<double>::infinity();
+				break;
+			}
+			length += weights_[e];
+		}
+		if (length < best_length) {
+			best = &edges;
+			best_length = length;
+		}
+	}
+	if (!best) return nullptr;
+
+	recent_path_.length = best_length;
+	recent_path_.network_group = group_;
+	recent_path_.arcs.clear();
+	auto v = topology_->sink;
+	for (auto e : *best) {
+		append_arcs(e, v, recent_path_.arcs);
+		v = topology_->in_sources[e];
+	}
+	return &recent_path_;
+}
+
+/** Greedily build paths that cover the given arcs, e.g. to seed the master problem with initial columns
+ * For each uncovered arc (u, v) a path is assembled from a source-u path, the arc itself and a v-sink path.
+ * The partial paths are taken from a predecessor tree of the source and a successor tree of the sink,
+ * so every path covers at least one new arc and the edge weights are not considered.
+ * Arcs that are not part of this network or do not lie on any source-sink path are skipped.
+ * @param max_paths upper bound on the number of returned paths, zero means no bound
+ * @return Paths of length zero, arcs ordered from the sink to the source (as returned by shortest_path())
+ */
+std::vector<Path> Network::covering_paths(const std::vector<Arc>& arcs, int max_paths) {
+	const auto& topology = *topology_;
+	std::uint32_t n_vertices = get_vertex_count();
+
+	// edge from the predecessor on some source-v path and to the successor on some v-sink path
+	std::vector<std::uint32_t> pred_edge(n_vertices, c_no_edge);
+	std::vector<std::uint32_t> succ_edge(n_vertices, c_no_edge);
+	std::vector<bool> from_source(n_vertices, false);
+	std::vector<bool> to_sink(n_vertices, false);
+	from_source[topology.source] = true;
+	to_sink[topology.sink] = true;
+	for (std::uint32_t v = 0; v < n_vertices; v++) {
+		for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1] && !from_source[v]; e++) {
+			if (!from_source[topology.in_sources[e]]) continue;
+			from_source[v] = true;
+			pred_edge[v] = e;
+		}
+	}
+	for (std::uint32_t v = n_vertices; v-- > 0;) {
+		if (!to_sink[v]) continue;
+		for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) {
+			auto u = topology.in_sources[e];
+			if (to_sink[u]) continue;
+			to_sink[u] = true;
+			succ_edge[u] = e;
+		}
+	}
+
+	std::vector<Path> paths;
+	std::vector<bool> covered(get_edge_count(), false);
+	for (const auto& arc : arcs) {
+		if (max_paths > 0 && (int) paths.size() >= max_paths) break;
+		auto edge = find_edge(arc);
+		if (edge == c_no_edge || edge == c_pruned_edge || covered[edge]) continue;
+		auto edge_source = topology.in_sources[edge];
+		auto edge_target = get_edge_target(edge);
+		if (!from_source[edge_source] || !to_sink[edge_target]) continue;
+
+		// collect the edges from sink to source
+		std::vector<std::uint32_t> path_edges;
+		for (auto v = edge_target; v != topology.sink; v = get_edge_target(succ_edge[v])) path_edges.push_back(succ_edge[v]);
+		std::reverse(path_edges.begin(), path_edges.end());
+		path_edges.push_back(edge);
+		for (auto v = edge_source; v != topology.source; v = topology.in_sources[pred_edge[v]]) path_edges.push_back(pred_edge[v]);
+
+		Path path{0, {}, group_};
+		path.arcs.reserve(path_edges.size());
+		for (auto e : path_edges) {
+			covered[e] = true;
+			append_arcs(e, get_edge_target(e), path.arcs);
+		}
+		paths.push_back(std::move(path));
+	}
+	return paths;
+}
+
+bool Network::is_path(const std::vector<Arc>& arcs) const {
+	const auto& topology = *topology_;
+	if (arcs.empty()) return false;
+	auto v = topology.sink;
+	for (const auto& arc : arcs) {
+		if (find_vertex(arc.target) != v) return false;
+		auto edge = find_edge(arc);
+		if (edge == c_no_edge || edge == c_pruned_edge) return false;
+		v = find_vertex(arc.source);
+	}
+	return v == topology.source;
+}
+
+Node Network::get_node(std::uint32_t vertex) const {
+	Node node = states_[vertex_states_[vertex]];
+	node.zeitscheibe = vertex_slices_[vertex];
+	return node;
 }
 
-int Network::get_edge_weight(const Arc& arc) {
-	// if we want to stay fully atomic this needs to mutex
-	//const std::lock_guard<std::mutex> lock(graph_mutex_);
-	auto edge_res = arc_to_edge_map_.find(arc);
-	if (edge_res == arc_to_edge_map_.end())
-		ABORT_F("Tried to get edge weight of an arc (%s) without corresponding edge, or the arc to network mapping was wrong", arc.to_string().c_str());
-	auto edge = edge_res->second;
-	auto boost_edge = boost::edge(edge.source, edge.target, graph_);
-	if (!boost_edge.second) ABORT_F("Could not find a boost edge from boost source and target");
-	return get(boost::edge_weight, graph_, boost_edge.first);
+std::uint32_t Network::find_vertex(const Node& node) const {
+	Node state = node;
+	state.zeitscheibe = 0;
+	auto state_res = state_index_.find(state);
+	if (state_res == state_index_.end()) return c_no_vertex;
+	auto begin = state_vertices_.begin() + state_offsets_[state_res->second];
+	auto end = state_vertices_.begin() + state_offsets_[state_res->second + 1];
+	auto vertex = std::lower_bound(begin, end, node.zeitscheibe, [this](std::uint32_t v, int slice) { return vertex_slices_[v] < slice; });
+	if (vertex == end || vertex_slices_[*vertex] != node.zeitscheibe) return c_no_vertex;
+	return *vertex;
+}
+
+/** The edge is found among the in-edges of the target, of which there are only a few per vertex,
+ * or, for arcs of vertices removed by reduce, among the vertices of the contracted edge
+ */
+std::uint32_t Network::find_edge(const Arc& arc) const {
+	const auto& topology = *topology_;
+	auto target = find_vertex(arc.target);
+	if (target == c_no_vertex) return c_no_edge;
+	auto source = find_vertex(arc.source);
+	if (source == c_no_vertex) return c_no_edge;
+	std::uint32_t n_vertices = get_vertex_count();
+	if (source >= n_vertices || target >= n_vertices) {
+		auto edge = removed_vertex_edges_[(target >= n_vertices ? target : source) - n_vertices];
+		if (edge == c_no_edge) return c_pruned_edge;
+		// the arc has to connect consecutive vertices of the contracted edge
+		auto previous = topology.in_sources[edge];
+		for (auto i = expansion_offsets_[edge]; i <= expansion_offsets_[edge + 1]; i++) {
+			auto next = (i < expansion_offsets_[edge + 1]) ? expansion_vertices_[i] : get_edge_target(edge);
+			if (previous == source && next == target) return edge;
+			previous = next;
+		}
+		return c_no_edge;
+	}
+	for (auto e = topology.in_offsets[target]; e < topology.in_offsets[target + 1]; e++)
+		if (topology.in_sources[e] == source && !has_expansion(e)) return e;
+	return c_no_edge;
+}
+
+void Network::append_arcs(std::uint32_t edge, std::uint32_t target, std::vector<Arc>& arcs) const {
+	auto v = target;
+	if (has_expansion(edge)) {
+		for (auto i = expansion_offsets_[edge + 1]; i-- > expansion_offsets_[edge];) {
+			arcs.push_back(Arc{get_node(expansion_vertices_[i]), get_node(v)});
+			v = expansion_vertices_[i];
+		}
+	}
+	arcs.push_back(Arc{get_node(topology_->in_sources[edge]), get_node(v)});
+}
+
+std::uint32_t Network::get_edge(const Arc& arc, const char* operation) const {
+	auto edge = find_edge(arc);
+	if (edge == c_no_edge)
+		ABORT_F("Tried to %s an arc (%s) without corresponding edge, or the arc to network mapping was wrong", operation, arc.to_string().c_str());
+	return edge;
+}
+
+std::uint32_t Network::get_edge_target(std::uint32_t edge) const {
+	return std::upper_bound(topology_->in_offsets.begin(), topology_->in_offsets.end(), edge) - topology_->in_offsets.begin() - 1;
+}
+
+void Network::share_topology(const Network& other) {
+	assert(*topology_ == *other.topology_);
+	topology_ = other.topology_;
+}
+
+void Network::reallocate() {
+	if (topology_.use_count() == 1) topology_ = std::make_shared<NetworkTopology>(*topology_);
+	weights_ = std::vector<double>(weights_);
+	swept_weights_ = std::vector<double>(swept_weights_);
+	recent_paths_ = std::vector<std::vector<std::uint32_t>>(recent_paths_);
+	states_ = std::vector<Node>(states_);
+	state_index_ = std::unordered_map<Node, std::uint32_t>(state_index_);
+	vertex_states_ = std::vector<std::uint32_t>(vertex_states_);
+	vertex_slices_ = std::vector<int>(vertex_slices_);
+	state_offsets_ = std::vector<std::uint32_t>(state_offsets_);
+	state_vertices_ = std::vector<std::uint32_t>(state_vertices_);
+	expansion_offsets_ = std::vector<std::uint32_t>(expansion_offsets_);
+	expansion_vertices_ = std::vector<std::uint32_t>(expansion_vertices_);
+	removed_vertex_edges_ = std::vector<std::uint32_t>(removed_vertex_edges_);
+	shortest_path_.arcs = std::vector<Arc>(shortest_path_.arcs);
+}
+
+/** For an arc of a contracted edge, this is the weight of the whole edge. Arcs off every source-sink path have weight zero. */
+double Network::get_edge_weight(const Arc& arc) const {
+	auto edge = get_edge(arc, "get the edge weight of");
+	return (edge == c_pruned_edge) ? 0 : weights_[edge];
 }
 
 void Network::reset_edge_weights() {
-	//const std::lock_guard<std::mutex> lock(graph_mutex_);
 	shortest_path_is_fresh_ = false;
-	boost::property_map<dag_t, boost::edge_weight_t>::type edge_weight_map = get(boost::edge_weight, graph_);
-	boost::graph_traits<dag_t>::edge_iterator e_it, e_end;
-	for (std::tie(e_it, e_end) = boost::edges(graph_); e_it != e_end; ++e_it) {
-		boost::put(boost::edge_weight_t(), graph_, *e_it, 0);
-	}
+	std::fill(weights_.begin(), weights_.end(), 0);
 }
 
 void Network::set_edge_weight(const Arc& arc, double weight) {
-	//const std::lock_guard<std::mutex> lock(graph_mutex_);
 	shortest_path_is_fresh_ = false;
-	auto edge_res = arc_to_edge_map_.find(arc);
-	if (edge_res == arc_to_edge_map_.end())
-		ABORT_F("Tried to set edge weight on an arc (%s) without corresponding edge, or the arc to network mapping was wrong", arc.to_string().c_str());
-	auto edge = edge_res->second;
-	auto boost_edge = boost::edge(edge.source, edge.target, graph_);
-	if (!boost_edge.second) ABORT_F("Could not find a boost edge from boost source and target");
-	boost::put(boost::edge_weight_t(), graph_, boost_edge.first, weight);
+	auto edge = get_edge(arc, "set the edge weight on");
+	if (edge != c_pruned_edge) weights_[edge] = weight;
 }
 
 void Network::add_to_edge_weight(const Arc& arc, double weight) {
-	//const std::lock_guard<std::mutex> lock(graph_mutex_);
+	add_to_edge_weight(get_edge(arc, "add to the edge weight on"), weight);
+}
+
+void Network::add_to_edge_weight(std::uint32_t edge, double weight) {
 	shortest_path_is_fresh_ = false;
-	auto edge_res = arc_to_edge_map_.find(arc);
-	if (edge_res == arc_to_edge_map_.end())
-		ABORT_F("Tried to add to edge weight on an arc (%s) without corresponding edge, or the arc to network mapping was wrong", arc.to_string().c_str());
-	auto edge = edge_res->second;
-	auto boost_edge = boost::edge(edge.source, edge.target, graph_);
-	if (!boost_edge.second) ABORT_F("Could not find a boost edge from boost source and target");
-	auto current_weight = get(boost::edge_weight, graph_, boost_edge.first);
-	boost::put(boost::edge_weight_t(), graph_, boost_edge.first, current_weight + weight);
+	if (edge != c_pruned_edge) weights_[edge] += weight;
+}
+
+/** Forbidden edges get the infinite weight DBL_MAX, so they are never relaxed */
+void Network::forbid_edge(const Arc& arc) {
+	set_edge_weight(arc, (std::numeric_limits<double>::max)());
 }
 
-bool Edge::operator<(const Edge& rhs) const {
-	return std::tie(source, target) <
-		std::tie(rhs.source, rhs.target);
+/** A topology shared by several networks is accounted to each of them in full */
+std::size_t Network::get_graph_bytes() const {
+	return topology_->get_bytes() + vector_bytes(weights_) + vector_bytes(swept_weights_) + vector_bytes(expansion_offsets_) + vector_bytes(expansion_vertices_);
 }
 
-bool Edge::operator==(const Edge& rhs) const {
-	return
-		source == rhs.source &&
-		target == rhs.target;
+std::size_t Network::get_map_bytes() const {
+	std::size_t bytes = vector_bytes(states_) + unordered_map_bytes(state_index_) + vector_bytes(vertex_states_) + vector_bytes(vertex_slices_)
+		+ vector_bytes(state_offsets_) + vector_bytes(state_vertices_) + vector_bytes(removed_vertex_edges_) + vector_bytes(shortest_path_.arcs);
+	for (const auto& edges : recent_paths_) bytes += vector_bytes(edges);
+	return bytes + vector_bytes(recent_paths_) + vector_bytes(path_edges_) + vector_bytes(recent_path_.arcs);
 }
@@ -23,83 +23,210 @@
 #ifndef __NETWORK_HPP
 #define __NETWORK_HPP
 
+#include <cstdint>
 #include <functional>
-#include <map>
-//#include <mutex>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include <boost/container_hash/hash.hpp>
-#include <boost/graph/dag_shortest_paths.hpp>
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
-#include "loguru.hpp"
+#include "logging.hpp"
 
 #include "Arc.hpp"
 #include "Node.hpp"
 #include "Path.hpp"
 
-typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS,
-		boost::property<boost::vertex_distance_t, double>, boost::property<boost::edge_weight_t, double> > dag_t;
-typedef boost::property_map<dag_t, boost::vertex_distance_t>::type distance_map_t;
+class TaskPool;
 
-/**
- * @brief Represents a boost edge and supports ordering such that it may be used as a key
- * @author Jurek Olden (jurek.olden@in.tum.de)
- *
- * We differentiate between 'arcs' as the mathematical object and 'edges' as the concrete implementation using boost::edge.
- * This Edge class is only used within the Network class, so there should not be any confusion.
+/** Reusable working memory of the shortest path computation
+ * The buffers only grow, so a scratch object kept per worker thread reaches the size of the largest network after the first sweep
+ * and shortest path computations do not allocate anymore.
+ */
+struct ShortestPathScratch {
+	std::vector<double> distance;
+	std::vector<std::uint32_t> pred_edge;
+
+	/// Grow the buffers to at least n_vertices entries
+	void reserve(std::size_t n_vertices);
+};
+
+/** Graph structure of a network in compressed sparse row format by target
+ * Vertices are numbered in topological order by level (the length of the longest path from a vertex without in-edges),
+ * so there are no edges within a level. In the time-expanded networks a level mostly corresponds to a time slice.
+ * Networks with identical structure share one topology, see Network::share_topology.
  */
-struct Edge {
-	dag_t::vertex_descriptor source;
-	dag_t::vertex_descriptor target;
+struct NetworkTopology {
+	std::uint32_t source;
+	std::uint32_t sink;
+	/// the in-edges of vertex v are [in_offsets[v], in_offsets[v + 1])
+	std::vector<std::uint32_t> in_offsets;
+	std::vector<std::uint32_t> in_sources;
+	/// the vertices of level l are [level_offsets[l], level_offsets[l + 1])
+	std::vector<std::uint32_t> level_offsets;
 
-	bool operator<(const Edge& rhs) const;
-	bool operator==(const Edge& rhs) const;
+	bool operator==(const NetworkTopology& rhs) const;
+	std::size_t hash() const;
+	std::size_t get_bytes() const;
 };
 
-namespace std {
-	template<> struct hash<Edge> {
-		std::size_t operator()(const Edge& edge) const noexcept {
-			std::size_t seed = 0;
-			boost::hash_combine(seed, edge.source);
-			boost::hash_combine(seed, edge.target);
-			return seed;
-		}
-	};
-}
-
-/** Represents a network and supports associated operations such as calculating the shortest path and manipulating arc weights */
+/** Represents a network and supports associated operations such as calculating the shortest path and manipulating arc weights
+ * After reading, the graph is stored as a NetworkTopology and the weights of the edges in an array of the same order.
+ * We differentiate between 'arcs' as the mathematical object and 'edges' as their index in these arrays.
+ * Arcs are not stored: the networks are time-expanded, so the node of a vertex is stored as its state (the node without
+ * its time slice), which is shared by the copies of the vertex in all time slices, and its time slice.
+ */
 class Network {
 	public:
+		struct ReductionStats {
+			std::size_t vertices_before;
+			std::size_t edges_before;
+			std::size_t vertices_after;
+			std::size_t edges_after;
+		};
+
 		Network(const std::string &filename, std::vector<Arc>& arc_list);
+		/** Removes the vertices which lie on no source-sink path and contracts chains of unweighted edges into single edges
+		 * Paths are still reported with all arcs of the original network, and all of its arcs are still accepted by the weight functions.
+		 * Resets the edge weights and replaces the topology, so it is no longer shared with other networks.
+		 * @param is_weighted if the weight of an arc can become nonzero, e.g. because it appears in a pricing constraint
+		 */
+		ReductionStats reduce(const std::function<bool(const Arc&)>& is_weighted);
+		/// Computes the shortest source-sink path with the scratch buffers of the calling thread, returns a copy of it
 		Path shortest_path();
+		/** Computes the shortest source-sink path using the given buffers
+		 * @return the path cached in the network (arcs from the sink to the source), valid until the next weight change
+		 */
+		const Path& shortest_path(ShortestPathScratch& scratch);
+		/** Stores the result of a sweep over the topology of this network as its cached shortest path, e.g. of a NetworkBatch
+		 * The distance and the predecessor edge of vertex v are read at index v * stride.
+		 */
+		template<typename E>
+		const Path& store_shortest_path(const double* distance, const E* pred_edge, std::size_t stride);
+		/** Like shortest_path(scratch), but the vertices of each level are relaxed in parallel on the pool
+		 * Synchronizes the pool once per level, so this pays off for very large networks only.
+		 * Must not be called from a task of the same pool.
+		 */
+		const Path& shortest_path(ShortestPathScratch& scratch, TaskPool& tpool);
+		/** Lower bound on the length of every source-sink path under the current weights, much cheaper than a sweep
+		 * The first call enables keeping the weights of every following sweep, which makes the bound tighter but needs memory for a second weight array.
+		 */
+		double length_bound();
+		/** Re-evaluates the last c_recent_paths computed shortest paths under the current weights, a heuristic much cheaper than a sweep
+		 * The first call enables remembering the paths of every following sweep.
+		 * @return the shortest of them (the exact shortest path if it is fresh), valid until the next call, nullptr if there is none
+		 */
+		const Path* shortest_recent_path();
+		/// Returns source-sink paths such that each of the given arcs which lies on any source-sink path is covered by at least one of them
+		std::vector<Path> covering_paths(const std::vector<Arc>& arcs, int max_paths);
+		/// Checks if the arcs (ordered from sink to source) form a source-sink path of this network
+		bool is_path(const std::vector<Arc>& arcs) const;
 
 		void reset_edge_weights();
 		void set_edge_weight(const Arc& arc, double weight);
 		void add_to_edge_weight(const Arc& arc, double weight);
+		/// Like add_to_edge_weight(arc, weight) for an edge of get_edge_index, without looking up the arc
+		void add_to_edge_weight(std::uint32_t edge, double weight);
+		/// Edge of an arc for repeated weight updates, valid until the network is reduced. Aborts if the arc is not part of the network
+		std::uint32_t get_edge_index(const Arc& arc) const { return get_edge(arc, "look up the edge of"); }
+		/// If the arc is part of the network (possibly contracted into an edge, or removed by reduce)
+		bool has_edge(const Arc& arc) const { return find_edge(arc) != c_no_edge; }
+		/// Excludes the edge from all paths until the weights are reset, e.g. to enforce a branching decision
+		void forbid_edge(const Arc& arc);
 
-		// these can be const and atomic because the graph does not change after initialization
+		// these can be const because the graph does not change after initialization
 		int get_group() const { return group_; }
-		int get_vertex_count() const { return boost::num_vertices(graph_); }
-		int get_edge_count() const { return boost::num_edges(graph_); }
-		// this shouldn't be const because we need to mutex the graph (to stay atomic, in case of async weight manipulation)
-		int get_edge_weight(const Arc& arc);
+		int get_vertex_count() const { return topology_->in_offsets.size() - 1; }
+		int get_edge_count() const { return topology_->in_sources.size(); }
+		int get_level_count() const { return topology_->level_offsets.size() - 1; }
+		/// Distinct states (nodes without time slice), each stored once for all its vertices
+		int get_state_count() const { return states_.size(); }
+		const NetworkTopology& get_topology() const { return *topology_; }
+		/// Edge weights in the order of the in-edges of the topology
+		const std::vector<double>& get_weights() const { return weights_; }
+		/// If the cached shortest path is valid for the current weights
+		bool is_shortest_path_fresh() const { return shortest_path_is_fresh_; }
+		/// Use the topology of the other network, which has to be identical, to save memory
+		void share_topology(const Network& other);
+		/// Copies the memory of the network on the calling thread, so it is first touched there (topologies shared with other networks stay)
+		void reallocate();
+		double get_edge_weight(const Arc& arc) const;
+		/// Bytes held by the graph arrays (in-edge offsets, sources and weights)
+		std::size_t get_graph_bytes() const;
+		/// Estimated bytes held by the node/vertex maps, including the cached shortest path
+		std::size_t get_map_bytes() const;
 
 	private:
+		static constexpr std::uint32_t c_no_edge = UINT32_MAX;
+		static constexpr std::uint32_t c_no_vertex = UINT32_MAX;
+		static const std::size_t c_recent_paths = 4;
+		/// edge of an arc of the original network which was removed by reduce because it lies on no source-sink path
+		static constexpr std::uint32_t c_pruned_edge = UINT32_MAX - 1;
+
+		/** Numbers the vertices in topological order by level and stores the edges in CSR format by target
+		 * @param position receives the topological index of every vertex
+		 * @param edge_index receives the CSR index of every edge
+		 * @return nullptr if the graph contains a cycle
+		 */
+		static std::shared_ptr<NetworkTopology> build_topology(std::uint32_t n_vertices, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges,
+				std::uint32_t source, std::uint32_t sink, std::vector<std::uint32_t>& position, std::vector<std::uint32_t>& edge_index);
+		/// Builds the vertex lists of the states from the states and time slices of the vertices
+		void index_states();
+		bool has_expansion(std::uint32_t edge) const { return !expansion_offsets_.empty() && expansion_offsets_[edge] != expansion_offsets_[edge + 1]; }
+		/// Appends the arcs of an edge, all arcs of the chain if it was contracted, ordered from its target to its source
+		void append_arcs(std::uint32_t edge, std::uint32_t target, std::vector<Arc>& arcs) const;
+
+		/// levels with fewer vertices are relaxed by the calling thread in the parallel sweep
+		static const std::uint32_t c_min_parallel_level = 1024;
+
+		/// Relaxes the in-edges of the vertices [begin, end), which must not depend on each other
+		void relax(std::uint32_t begin, std::uint32_t end, double* distance, std::uint32_t* pred_edge) const;
+		/// Starts a sweep: initializes the distances of all vertices, returns false if the cached path is still fresh
+		bool init_sweep(ShortestPathScratch& scratch);
+		/// Node of a vertex, assembled from its state and time slice
+		Node get_node(std::uint32_t vertex) const;
+		/// Vertex of a node, c_no_vertex if the node is not part of this network
+		std::uint32_t find_vertex(const Node& node) const;
+		/// Edge of an arc, c_no_edge if the arc is not part of this network, c_pruned_edge if it was removed by reduce
+		std::uint32_t find_edge(const Arc& arc) const;
+		/// Like find_edge, but aborts if the arc is not part of this network (c_pruned_edge is returned)
+		std::uint32_t get_edge(const Arc& arc, const char* operation) const;
+		/// Topological index of the target of an edge
+		std::uint32_t get_edge_target(std::uint32_t edge) const;
 
 		int group_;
 		Path shortest_path_;
 		bool shortest_path_is_fresh_;
-		//std::mutex graph_mutex_;
-		dag_t graph_;
-		dag_t::vertex_descriptor source_;
-		dag_t::vertex_descriptor sink_;
-		std::map<int, std::pair<dag_t::vertex_descriptor, Node>> id_map_;
-		std::unordered_map<Arc, Edge> arc_to_edge_map_;
-		std::unordered_map<Edge, Arc> edge_to_arc_map_;
+		std::shared_ptr<const NetworkTopology> topology_;
+		std::vector<double> weights_;
+		/// weights and shortest path length of the last sweep, kept once length_bound was called
+		bool keep_swept_weights_;
+		std::vector<double> swept_weights_;
+		double swept_length_;
+		/// edges (from the sink to the source) of the shortest paths of the last sweeps, kept once shortest_recent_path was called
+		bool keep_recent_paths_;
+		std::vector<std::vector<std::uint32_t>> recent_paths_;
+		std::size_t next_recent_path_;
+		std::vector<std::uint32_t> path_edges_;
+		Path recent_path_;
+		/// distinct nodes with time slice zero, by index
+		std::vector<Node> states_;
+		std::unordered_map<Node, std::uint32_t> state_index_;
+		std::vector<std::uint32_t> vertex_states_;
+		std::vector<int> vertex_slices_;
+		/// the vertices of state s, ordered by time slice, are state_vertices_[state_offsets_[s], state_offsets_[s + 1])
+		std::vector<std::uint32_t> state_offsets_;
+		std::vector<std::uint32_t> state_vertices_;
+		/** Vertices removed by reduce are numbered after the vertices of the topology
+		 * The vertices inside the contracted edge e, from its source to its target, are expansion_vertices_[expansion_offsets_[e], expansion_offsets_[e + 1]),
+		 * removed_vertex_edges_[v - get_vertex_count()] is the contracted edge containing the removed vertex v, c_no_edge if it lies on no source-sink path.
+		 * All empty as long as the network was not reduced.
+		 */
+		std::vector<std::uint32_t> expansion_offsets_;
+		std::vector<std::uint32_t> expansion_vertices_;
+		std::vector<std::uint32_t> removed_vertex_edges_;
 };
 
 #endif
@@ -0,0 +1,188 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "NetworkBatch.hpp"
+
+#include <assert.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+	const std::size_t c_lanes = NetworkBatch::c_lanes;
+	const double c_infinity = (std::numeric_limits<double>::max)();
+
+	/// Lane buffers of a sweep, the entry of vertex or edge i and network l is at i * c_lanes + l
+	struct BatchScratch {
+		std::vector<double> weights;
+		std::vector<double> distance;
+		std::vector<std::uint64_t> pred_edge;
+	};
+
+	/** Relaxes the in-edges of the vertices [begin, end) for all lanes
+	 * Same semantics as Network::relax per lane: infinite distances and weights are skipped, ties keep the first edge.
+	 */
+	void relax_lanes(const NetworkTopology& topology, std::uint32_t begin, std::uint32_t end,
+			const double* weights, double* distance, std::uint64_t* pred_edge) {
+#if defined(__AVX512F__)
+		static_assert(c_lanes == 8, "one AVX-512 register per vertex");
+		const __m512d infinity = _mm512_set1_pd(c_infinity);
+		for (std::uint32_t v = begin; v < end; v++) {
+			__m512d best = infinity;
+			__m512i best_edge = _mm512_set1_epi64(-1);
+			for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) {
+				__m512d d = _mm512_loadu_pd(distance + topology.in_sources[e] * c_lanes);
+				__m512d w = _mm512_loadu_pd(weights + e * c_lanes);
+				__m512d candidate = _mm512_add_pd(d, w);
+				__mmask8 better = _mm512_cmp_pd_mask(d, infinity, _CMP_NEQ_OQ)
+					& _mm512_cmp_pd_mask(w, infinity, _CMP_NEQ_OQ)
+					& _mm512_cmp_pd_mask(candidate, best, _CMP_LT_OQ);
+				best = _mm512_mask_blend_pd(better, best, candidate);
+				best_edge = _mm512_mask_blend_epi64(better, best_edge, _mm512_set1_epi64(e));
+			}
+			_mm512_storeu_pd(distance + v * c_lanes, best);
+			_mm512_storeu_si512(pred_edge + v * c_lanes, best_edge);
+		}
+#elif defined(__AVX2__)
+		static_assert(c_lanes == 8, "two AVX2 registers per vertex");
+		const __m256d infinity = _mm256_set1_pd(c_infinity);
+		for (std::uint32_t v = begin; v < end; v++) {
+			__m256d best[2] = {infinity, infinity};
+			__m256d best_edge[2] = {_mm256_castsi256_pd(_mm256_set1_epi64x(-1)), _mm256_castsi256_pd(_mm256_set1_epi64x(-1))};
+			for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) {
+				const double* d_ptr = distance + topology.in_sources[e] * c_lanes;
+				const double* w_ptr = weights + e * c_lanes;
+				__m256d edge = _mm256_castsi256_pd(_mm256_set1_epi64x(e));
+				for (int h = 0; h < 2; h++) {
+					__m256d d = _mm256_loadu_pd(d_ptr + 4 * h);
+					__m256d w = _mm256_loadu_pd(w_ptr + 4 * h);
+					__m256d candidate = _mm256_add_pd(d, w);
+					__m256d better = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(d, infinity, _CMP_NEQ_OQ), _mm256_cmp_pd(w, infinity, _CMP_NEQ_OQ)),
+						_mm256_cmp_pd(candidate, best[h], _CMP_LT_OQ));
+					best[h] = _mm256_blendv_pd(best[h], candidate, better);
+					best_edge[h] = _mm256_blendv_pd(best_edge[h], edge, better);
+				}
+			}
+			for (int h = 0; h < 2; h++) {
+				_mm256_storeu_pd(distance + v * c_lanes + 4 * h, best[h]);
+				_mm256_storeu_si256((__m256i*) (pred_edge + v * c_lanes + 4 * h), _mm256_castpd_si256(best_edge[h]));
+			}
+		}
+#else
+		for (std::uint32_t v = begin; v < end; v++) {
+			double best[c_lanes];
+			std::uint64_t best_edge[c_lanes];
+			std::fill_n(best, c_lanes, c_infinity);
+			std::fill_n(best_edge, c_lanes, UINT64_MAX);
+			for (auto e = topology.in_offsets[v]; e < topology.in_offsets[v + 1]; e++) {
+				const double* d = distance + topology.in_sources[e] * c_lanes;
+				const double* w = weights + e * c_lanes;
+				for (std::size_t l = 0; l < c_lanes; l++) {
+					bool better = d[l] != c_infinity && w[l] != c_infinity && d[l] + w[l] < best[l];
+					best[l] = better ? d[l] + w[l] : best[l];
+					best_edge[l] = better ? e : best_edge[l];
+				}
+			}
+			std::copy_n(best, c_lanes, distance + v * c_lanes);
+			std::copy_n(best_edge, c_lanes, pred_edge + v * c_lanes);
+		}
+#endif
+	}
+}
+
+NetworkBatch::NetworkBatch(std::vector<Network*> networks) :
+	networks_(std::move(networks)) {
+		assert(!networks_.empty() && networks_.size() <= c_lanes);
+		for (auto net : networks_) assert(&net->get_topology() == &networks_[0]->get_topology());
+}
+
+bool NetworkBatch::shortest_paths(std::uint32_t skip_mask) {
+	auto needed = [&](std::size_t l) { return !networks_[l]->is_shortest_path_fresh() && !(skip_mask & (1u << l)); };
+	std::size_t n_needed = 0;
+	for (std::size_t l = 0; l < networks_.size(); l++) n_needed += needed(l);
+	if (n_needed == 0) return false;
+	// a single network is cheaper with the scalar sweep
+	if (n_needed == 1) {
+		for (std::size_t l = 0; l < networks_.size(); l++)
+			if (needed(l)) networks_[l]->shortest_path();
+		return true;
+	}
+
+	thread_local BatchScratch s_scratch;
+	const auto& topology = networks_[0]->get_topology();
+	std::size_t n_vertices = topology.in_offsets.size() - 1;
+	std::size_t n_edges = topology.in_sources.size();
+	if (s_scratch.distance.size() < n_vertices * c_lanes) {
+		s_scratch.distance.resize(n_vertices * c_lanes);
+		s_scratch.pred_edge.resize(n_vertices * c_lanes);
+	}
+	if (s_scratch.weights.size() < n_edges * c_lanes) s_scratch.weights.resize(n_edges * c_lanes);
+	// unused lanes get infinite weights, so they never relax an edge
+	const double* lane_weights[c_lanes];
+	for (std::size_t l = 0; l < c_lanes; l++) lane_weights[l] = (l < networks_.size()) ? networks_[l]->get_weights().data() : nullptr;
+	double* weights = s_scratch.weights.data();
+	for (std::size_t e = 0; e < n_edges; e++)
+		for (std::size_t l = 0; l < c_lanes; l++) weights[e * c_lanes + l] = lane_weights[l] ? lane_weights[l][e] : c_infinity;
+	std::fill_n(s_scratch.distance.data(), n_vertices * c_lanes, c_infinity);
+	std::fill_n(s_scratch.distance.data() + topology.source * c_lanes, c_lanes, 0.0);
+
+	relax_lanes(topology, topology.source + 1, n_vertices, s_scratch.weights.data(), s_scratch.distance.data(), s_scratch.pred_edge.data());
+	for (std::size_t l = 0; l < networks_.size(); l++) {
+		if (!needed(l)) continue;
+		networks_[l]->store_shortest_path(s_scratch.distance.data() + l, s_scratch.pred_edge.data() + l, c_lanes);
+	}
+	return true;
+}
+
+std::vector<NetworkBatch> NetworkBatch::make_batches(const std::vector<Network*>& networks) {
+	// groups of identical topology in order of their first network, found via the topology hash
+	std::vector<std::vector<Network*>> groups;
+	std::unordered_multimap<std::size_t, std::size_t> groups_by_hash;
+	for (auto net : networks) {
+		auto hash = net->get_topology().hash();
+		auto range = groups_by_hash.equal_range(hash);
+		auto group = std::find_if(range.first, range.second, [&](const std::pair<const std::size_t, std::size_t>& entry) {
+			return groups[entry.second][0]->get_topology() == net->get_topology();
+		});
+		if (group == range.second) {
+			groups_by_hash.insert(std::make_pair(hash, groups.size()));
+			groups.push_back({net});
+		} else {
+			net->share_topology(*groups[group->second][0]);
+			groups[group->second].push_back(net);
+		}
+	}
+
+	std::vector<NetworkBatch> batches;
+	for (const auto& group : groups) {
+		for (std::size_t begin = 0; begin + 1 < group.size(); begin += c_lanes) {
+			std::size_t end = std::min(group.size(), begin + c_lanes);
+			batches.emplace_back(std::vector<Network*>(group.begin() + begin, group.begin() + end));
+		}
+	}
+	return batches;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#ifndef __NETWORKBATCH_HPP
+#define __NETWORKBATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Network.hpp"
+
+/** Computes the shortest paths of up to c_lanes networks with identical topology in one vectorized sweep
+ * Every vertex of the shared topology holds one distance per network, stored next to each other (structure of arrays),
+ * so relaxing an edge is one vector add, compare and blend for all networks (AVX-512 or AVX2 if enabled at compile time,
+ * see the CMake option HALLIGALLI_NATIVE_ARCH, otherwise a lane loop the compiler may vectorize).
+ * The networks keep their own weights, which are transposed into the lane layout at the start of every sweep.
+ * The results are stored as the cached shortest paths of the networks and are identical to Network::shortest_path.
+ */
+class NetworkBatch {
+	public:
+		static constexpr std::size_t c_lanes = 8;
+
+		/// The networks have to share one topology (see Network::share_topology), at most c_lanes of them
+		NetworkBatch(std::vector<Network*> networks);
+
+		/** Computes the shortest path of every network whose cached path is stale
+		 * Uses buffers of the calling thread, so batches can be computed concurrently.
+		 * @param skip_mask bit l set excludes the l-th network, e.g. because it can not have a negative path
+		 * @return if a sweep was needed
+		 */
+		bool shortest_paths(std::uint32_t skip_mask = 0);
+		const std::vector<Network*>& get_networks() const { return networks_; }
+
+		/** Groups the networks by identical topology into batches, letting the networks of a group share one topology
+		 * Networks without a topologically identical partner are not part of any batch.
+		 */
+		static std::vector<NetworkBatch> make_batches(const std::vector<Network*>& networks);
+
+	private:
+		std::vector<Network*> networks_;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "NetworkScheduler.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+NetworkScheduler::NetworkScheduler() :
+	partitioned_(false) {}
+
+void NetworkScheduler::plan(const std::vector<Network*>& networks, int n_workers) {
+	partitioned_ = false;
+	std::size_t n_networks = networks.size();
+	if (runtime_ns_.size() != n_networks) runtime_ns_.assign(n_networks, std::numeric_limits<double>::quiet_NaN());
+
+	// runtime per edge of the networks priced before, to estimate the others
+	double measured_ns = 0;
+	double measured_edges = 0;
+	for (std::size_t i = 0; i < n_networks; i++) {
+		if (std::isnan(runtime_ns_[i])) continue;
+		measured_ns += runtime_ns_[i];
+		measured_edges += networks[i]->get_edge_count();
+	}
+	double ns_per_edge = (measured_edges > 0) ? measured_ns / measured_edges : c_default_ns_per_edge;
+	costs_.resize(n_networks);
+	for (std::size_t i = 0; i < n_networks; i++)
+		costs_[i] = std::isnan(runtime_ns_[i]) ? ns_per_edge * std::max(1, networks[i]->get_edge_count()) : runtime_ns_[i];
+
+	std::vector<std::size_t> order(n_networks);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return costs_[a] > costs_[b]; });
+
+	n_workers = std::max(1, n_workers);
+	double total_cost = std::accumulate(costs_.begin(), costs_.end(), 0.0);
+	double target_cost = total_cost / (n_workers * c_batches_per_worker);
+	batches_.clear();
+	std::vector<double> batch_costs;
+	std::vector<std::size_t> batch;
+	double batch_cost = 0;
+	for (auto i : order) {
+		batch.push_back(i);
+		batch_cost += costs_[i];
+		if (batch_cost < target_cost) continue;
+		batches_.push_back(std::move(batch));
+		batch_costs.push_back(batch_cost);
+		batch.clear();
+		batch_cost = 0;
+	}
+	if (!batch.empty()) {
+		batches_.push_back(std::move(batch));
+		batch_costs.push_back(batch_cost);
+	}
+
+	// batches are created by decreasing cost, except for a partly filled last one
+	fill_queues(batch_costs, n_workers);
+}
+
+bool NetworkScheduler::partition(const std::vector<Network*>& networks, int n_workers) {
+	if (partitioned_ && batches_.size() == networks.size()) return false;
+	partitioned_ = true;
+	std::vector<std::size_t> order(networks.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+		return networks[a]->get_edge_count() > networks[b]->get_edge_count();
+	});
+	batches_.clear();
+	std::vector<double> batch_costs;
+	for (auto i : order) {
+		batches_.push_back({i});
+		batch_costs.push_back(networks[i]->get_edge_count());
+	}
+	fill_queues(batch_costs, std::max(1, n_workers));
+	return true;
+}
+
+void NetworkScheduler::fill_queues(const std::vector<double>& batch_costs, int n_workers) {
+	queues_.assign(n_workers, std::vector<std::size_t>());
+	std::vector<double> loads(n_workers, 0.0);
+	for (std::size_t b = 0; b < batch_costs.size(); b++) {
+		auto worker = std::min_element(loads.begin(), loads.end()) - loads.begin();
+		queues_[worker].push_back(b);
+		loads[worker] += batch_costs[b];
+	}
+}
+
+void NetworkScheduler::record_runtime(std::size_t network, double runtime_ns) {
+	assert(network < runtime_ns_.size());
+	double& runtime = runtime_ns_[network];
+	runtime = std::isnan(runtime) ? runtime_ns : (1 - c_runtime_smoothing) * runtime + c_runtime_smoothing * runtime_ns;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __NETWORKSCHEDULER_HPP
+#define __NETWORKSCHEDULER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Network.hpp"
+
+/** Distributes the networks of a pricing sweep among the workers of the task pool by a cost model
+ * The cost of a network is the (smoothed) runtime of its previous shortest path computation,
+ * or, before it was priced the first time, its edge count scaled by the runtime per edge observed on the other networks.
+ * Networks are grouped into batches of similar cost: expensive networks form a batch of their own,
+ * cheap ones are combined until a batch reaches the target cost. Batches are assigned to worker queues
+ * by decreasing cost to the least loaded queue (longest processing time first), so each queue starts with its largest batch.
+ */
+class NetworkScheduler {
+	public:
+		NetworkScheduler();
+
+		/** Compute batches and worker queues for the given networks, which have to be passed in the same order on every call */
+		void plan(const std::vector<Network*>& networks, int n_workers);
+		/** Partition the networks statically among the workers, one batch per network, balanced by edge count
+		 * Only the first call computes the partition (unless plan was called or the networks changed in between),
+		 * so every network stays with the same queue and, via TaskPool::parallel_for_queues, the same worker.
+		 * @return if the partition was (re)computed
+		 */
+		bool partition(const std::vector<Network*>& networks, int n_workers);
+		/// Network indices (positions in the list passed to plan) of every batch
+		const std::vector<std::vector<std::size_t>>& get_batches() const { return batches_; }
+		/// Batch indices of every worker queue, by decreasing cost
+		const std::vector<std::vector<std::size_t>>& get_queues() const { return queues_; }
+		/// Estimated cost of a network in nanoseconds, as used by the last plan
+		double get_cost(std::size_t network) const { return costs_[network]; }
+		/** Store the measured shortest path runtime of a network, may be called concurrently for different networks
+		 * Only for networks of the last plan, which sizes the runtime table, partition does not.
+		 */
+		void record_runtime(std::size_t network, double runtime_ns);
+
+	private:
+		/// runtime per edge assumed while no network has been priced yet
+		static constexpr double c_default_ns_per_edge = 10.0;
+		/// weight of a new measurement in the smoothed runtime
+		static constexpr double c_runtime_smoothing = 0.5;
+		/// the target batch cost is the total cost divided by this many batches per worker
+		static const int c_batches_per_worker = 8;
+
+		/// distributes the batches by decreasing cost to the least loaded queue
+		void fill_queues(const std::vector<double>& batch_costs, int n_workers);
+
+		bool partitioned_;
+		std::vector<double> runtime_ns_;
+		std::vector<double> costs_;
+		std::vector<std::vector<std::size_t>> batches_;
+		std::vector<std::vector<std::size_t>> queues_;
+};
+
+#endif
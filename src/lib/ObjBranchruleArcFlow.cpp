@@ -0,0 +1,293 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "ObjBranchruleArcFlow.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "logging.hpp"
+
+#include "reporting.hpp"
+
+ObjBranchruleArcFlow::ObjBranchruleArcFlow(SCIP * scip, const std::string branchrule_name, DataManager& data_manager) :
+	ObjBranchrule(scip, branchrule_name.c_str(), "branching on the aggregated flow over network arcs", 50000, -1, 1.0),
+	n_branches_(0),
+	n_path_variables_(0),
+	data_manager_(data_manager) {
+		assert(scip != NULL);
+}
+
+ObjBranchruleArcFlow::~ObjBranchruleArcFlow() {}
+
+std::vector<std::pair<Path, long>> decompose_arc_flow(const std::unordered_map<Arc, double>& arc_flow, const std::vector<std::vector<Arc>>& columns) {
+	// sorted, such that the paths do not depend on the hash order
+	std::vector<std::pair<Arc, long>> flow;
+	for (const auto& pair : arc_flow) {
+		long value = std::lround(pair.second);
+		if (value > 0) flow.emplace_back(pair.first, value);
+	}
+	std::sort(flow.begin(), flow.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	std::unordered_map<Arc, std::size_t> arc_index;
+	for (std::size_t a = 0; a < flow.size(); a++) arc_index.emplace(flow[a].first, a);
+
+	std::vector<std::pair<Path, long>> paths;
+	auto add_path = [&](std::vector<Arc> arcs, long value) {
+		Path path;
+		path.length = 0;
+		path.network_group = -1;
+		path.arcs = std::move(arcs);
+		paths.emplace_back(std::move(path), value);
+	};
+	// existing columns first, such that their variables are reused
+	for (const auto& arcs : columns) {
+		long value = arcs.empty() ? 0 : LONG_MAX;
+		for (const auto& arc : arcs) {
+			auto it = arc_index.find(arc);
+			value = it == arc_index.end() ? 0 : std::min(value, flow[it->second].second);
+		}
+		if (value <= 0) continue;
+		for (const auto& arc : arcs) flow[arc_index.at(arc)].second -= value;
+		add_path(arcs, value);
+	}
+
+	std::unordered_map<Node, std::vector<std::size_t>> out_arcs;
+	std::unordered_map<Node, long> inflow;
+	for (std::size_t a = 0; a < flow.size(); a++) {
+		if (flow[a].second <= 0) continue;
+		out_arcs[flow[a].first.source].push_back(a);
+		inflow[flow[a].first.target] += flow[a].second;
+	}
+	std::vector<Node> starts;
+	for (const auto& pair : out_arcs)
+		if (inflow.find(pair.first) == inflow.end()) starts.push_back(pair.first);
+	std::sort(starts.begin(), starts.end());
+
+	const std::size_t none = flow.size();
+	auto next_arc = [&](const Node& node) {
+		auto it = out_arcs.find(node);
+		if (it == out_arcs.end()) return none;
+		for (auto a : it->second)
+			if (flow[a].second > 0) return a;
+		return none;
+	};
+	std::vector<std::size_t> path_arcs;
+	for (const auto& start : starts) {
+		// every path uses up the flow of at least one arc
+		for (auto first = next_arc(start); first != none; first = next_arc(start)) {
+			path_arcs.clear();
+			long value = LONG_MAX;
+			for (auto a = first; a != none; a = next_arc(flow[a].first.target)) {
+				path_arcs.push_back(a);
+				value = std::min(value, flow[a].second);
+			}
+			std::vector<Arc> arcs;
+			arcs.reserve(path_arcs.size());
+			for (auto a = path_arcs.rbegin(); a != path_arcs.rend(); ++a) {
+				flow[*a].second -= value;
+				arcs.push_back(flow[*a].first);
+			}
+			add_path(std::move(arcs), value);
+		}
+	}
+	return paths;
+}
+
+/** Branch on the arc whose aggregated flow is most fractional
+ * If all arc flows are integral, fractional path variables are replaced by a decomposition of the arc flow, see solve_integral_flow.
+ */
+SCIP_DECL_BRANCHEXECLP(ObjBranchruleArcFlow::scip_execlp) {
+	assert(scip != NULL);
+	(*result) = SCIP_DIDNOTRUN;
+
+	// aggregate the flow over each arc from the current LP solution
+	std::unordered_map<Arc, double> arc_flow;
+	std::unordered_map<Arc, std::vector<SCIP_VAR *>> vars_of_arc;
+	int nvars = SCIPgetNVars(scip);
+	SCIP_VAR ** vars = SCIPgetVars(scip);
+	for (int i = 0; i < nvars; i++) {
+		auto path_option = get_path_of_var(vars[i], data_manager_);
+		if (!path_option) continue;
+		double val = SCIPgetSolVal(scip, NULL, vars[i]);
+		for (const auto& arc : path_option->arcs) {
+			vars_of_arc[arc].push_back(vars[i]);
+			if (SCIPisPositive(scip, val)) arc_flow[arc] += val;
+		}
+	}
+
+	const Arc * branching_arc = nullptr;
+	double branching_flow = 0;
+	double best_score = 0;
+	for (const auto& pair : arc_flow) {
+		if (SCIPisFeasIntegral(scip, pair.second)) continue;
+		// prefer fractionality close to one half
+		double score = 0.5 - std::fabs(SCIPfeasFrac(scip, pair.second) - 0.5);
+		if (branching_arc == nullptr || score > best_score || (score == best_score && pair.first < *branching_arc)) {
+			branching_arc = &pair.first;
+			branching_flow = pair.second;
+			best_score = score;
+		}
+	}
+	if (branching_arc == nullptr) return solve_integral_flow(scip, arc_flow, result);
+
+	LOG_F(2, "Branching on flow %f over arc %s", branching_flow, branching_arc->format().c_str());
+	const auto& arc_vars = vars_of_arc.at(*branching_arc);
+	SCIP_CALL( create_branch(scip, *branching_arc, 0.0, SCIPfeasFloor(scip, branching_flow), arc_vars) );
+	SCIP_CALL( create_branch(scip, *branching_arc, SCIPfeasCeil(scip, branching_flow), SCIPinfinity(scip), arc_vars) );
+	(*result) = SCIP_BRANCHED;
+	return SCIP_OKAY;
+}
+
+/** Handle an LP solution with integral flow over every arc
+ * Fractional variables that are no path variables are branched on directly. If only path variables are fractional,
+ * the arc flow is decomposed into paths with integral flow, preferring the columns of the LP solution such that their variables
+ * are reused. Missing path variables are created, and the resulting solution
+ * is passed to SCIP. Path variables have no objective and contribute to the constraints only through their arcs,
+ * so the solution has the objective of the LP and the node is cut off.
+ */
+SCIP_RETCODE ObjBranchruleArcFlow::solve_integral_flow(SCIP * scip, const std::unordered_map<Arc, double>& arc_flow, SCIP_RESULT * result) {
+	SCIP_VAR ** candidates;
+	int n_candidates;
+	SCIP_CALL( SCIPgetLPBranchCands(scip, &candidates, NULL, NULL, &n_candidates, NULL, NULL) );
+	bool fractional_paths = false;
+	for (int i = 0; i < n_candidates; i++) {
+		if (get_path_of_var(candidates[i], data_manager_)) {
+			fractional_paths = true;
+			continue;
+		}
+		LOG_F(2, "Branching on variable %s, all arc flows are integral", SCIPvarGetName(candidates[i]));
+		SCIP_CALL( SCIPbranchVar(scip, candidates[i], NULL, NULL, NULL) );
+		(*result) = SCIP_BRANCHED;
+		return SCIP_OKAY;
+	}
+	if (!fractional_paths) return SCIP_OKAY;
+
+	int nvars = SCIPgetNVars(scip);
+	SCIP_VAR ** vars = SCIPgetVars(scip);
+	std::map<std::vector<Arc>, SCIP_VAR *> var_of_path;
+	// the columns of the LP solution, by decreasing value, are preferred in the decomposition
+	std::vector<std::pair<double, std::vector<Arc>>> lp_columns;
+	SCIP_SOL * sol = NULL;
+	SCIP_CALL( SCIPcreateSol(scip, &sol, NULL) );
+	for (int i = 0; i < nvars; i++) {
+		auto path_option = get_path_of_var(vars[i], data_manager_);
+		double val = SCIPgetSolVal(scip, NULL, vars[i]);
+		if (!path_option) {
+			SCIP_CALL( SCIPsetSolVal(scip, sol, vars[i], val) );
+			continue;
+		}
+		var_of_path.emplace(path_option->arcs, vars[i]);
+		if (SCIPisPositive(scip, val)) lp_columns.emplace_back(val, path_option->arcs);
+	}
+	std::sort(lp_columns.begin(), lp_columns.end(), [](const auto& a, const auto& b) { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+	std::vector<std::vector<Arc>> columns;
+	columns.reserve(lp_columns.size());
+	for (auto& pair : lp_columns) columns.push_back(std::move(pair.second));
+	auto paths = decompose_arc_flow(arc_flow, columns);
+	int n_created = 0;
+	for (auto& pair : paths) {
+		auto it = var_of_path.find(pair.first.arcs);
+		if (it != var_of_path.end()) {
+			SCIP_CALL( SCIPsetSolVal(scip, sol, it->second, pair.second) );
+			continue;
+		}
+		pair.first.network_group = data_manager_.get_network(pair.first.arcs.front()).get_group();
+		SCIP_VAR * var = NULL;
+		SCIP_CALL( create_path_variable(scip, pair.first, &var) );
+		SCIP_CALL( SCIPsetSolVal(scip, sol, var, pair.second) );
+		SCIP_CALL( SCIPreleaseVar(scip, &var) );
+		n_created++;
+	}
+	SCIP_Bool stored = FALSE;
+	SCIP_CALL( SCIPtrySolFree(scip, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored) );
+	LOG_F(1, "Decomposed the integral arc flow into %zu paths (%d new path variables), solution %s",
+			paths.size(), n_created, stored ? "stored" : "rejected");
+	// a rejected solution is still no better than the incumbent if the LP is not
+	if (stored || SCIPisGE(scip, SCIPgetLPObjval(scip), SCIPgetUpperbound(scip))) (*result) = SCIP_CUTOFF;
+	return SCIP_OKAY;
+}
+
+/** Like the priced variables of ObjPricerGFCG, the variable is added to the constraints of its arcs and to all arc flow constraints */
+SCIP_RETCODE ObjBranchruleArcFlow::create_path_variable(SCIP * scip, Path path, SCIP_VAR ** var) {
+	std::string varname = "p_arcflow_" + std::to_string(n_path_variables_++);
+	SCIP_CALL( SCIPcreateVarBasic(scip, var, varname.c_str(), 0, SCIPinfinity(scip), 0, SCIP_VARTYPE_INTEGER) );
+	SCIP_CALL( SCIPaddVar(scip, *var) );
+	for (const auto &arc : path.arcs) {
+		auto constraints_optional = data_manager_.get_constraints_of_arc(arc);
+		if (constraints_optional) {
+			for (const auto &cons_info : *constraints_optional) SCIP_CALL( SCIPaddCoefLinear(scip, cons_info.first, *var, cons_info.second) );
+		}
+		auto branching_optional = data_manager_.get_arc_flow_constraints_of_arc(arc);
+		if (branching_optional) {
+			for (const auto &cons_info : *branching_optional) SCIP_CALL( SCIPaddCoefLinear(scip, cons_info.first, *var, cons_info.second) );
+		}
+	}
+	data_manager_.add_var_path_pair(varname, std::move(path));
+	return SCIP_OKAY;
+}
+
+/** Release all branching constraints before the branch and bound data is freed */
+SCIP_DECL_BRANCHEXITSOL(ObjBranchruleArcFlow::scip_exitsol) {
+	assert(scip != NULL);
+	for (auto &cons : data_manager_.get_arc_flow_constraints()) {
+		SCIP_CALL( SCIPreleaseCons(scip, &cons.scip_constraint) );
+	}
+	data_manager_.clear_arc_flow_constraints();
+	return SCIP_OKAY;
+}
+
+/** Create a child node with the constraint lhs <= sum of all path variables using the arc <= rhs
+ * The constraint is modifiable, such that the pricer can add new path variables to it.
+ */
+SCIP_RETCODE ObjBranchruleArcFlow::create_branch(SCIP * scip, const Arc& arc, double lhs, double rhs, const std::vector<SCIP_VAR *>& vars) {
+	SCIP_NODE * child = NULL;
+	SCIP_CALL( SCIPcreateChild(scip, &child, 0.0, SCIPgetLocalTransEstimate(scip)) );
+
+	std::string cons_name = "arcflow_" + std::to_string(n_branches_++);
+	SCIP_CONS * cons = NULL;
+	SCIP_CALL( SCIPcreateConsLinear(scip, &cons, cons_name.c_str(), 0, NULL, NULL, lhs, rhs,
+				TRUE, // initial
+				FALSE, // separate
+				TRUE, // enforce
+				TRUE, // check
+				TRUE, // propagate
+				TRUE, // local
+				TRUE, // modifiable
+				FALSE, // dynamic
+				FALSE, // removable
+				TRUE) ); // stickingatnode
+	for (auto var : vars) {
+		SCIP_CALL( SCIPaddCoefLinear(scip, cons, var, 1.0) );
+	}
+	SCIP_CALL( SCIPaddConsNode(scip, child, cons, NULL) );
+
+	// the data manager keeps the constraint captured until exitsol
+	bool forbidden = SCIPisZero(scip, rhs);
+	data_manager_.add_arc_flow_constraint(ArcFlowConstraint{cons, arc, forbidden});
+	return SCIP_OKAY;
+}
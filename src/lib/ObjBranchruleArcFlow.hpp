@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __OBJBRANCHRULEARCFLOW_HPP
+#define __OBJBRANCHRULEARCFLOW_HPP
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <objscip/objscip.h>
+
+#include "DataManager.hpp"
+#include "Path.hpp"
+
+/** Decomposes an integral flow over the arcs of acyclic networks into paths with integral flow
+ * The given columns (arcs of existing paths) are taken first, in order, each with the largest flow the remaining arc flows allow.
+ * The rest is decomposed into paths that start at nodes without incoming flow and follow arcs with remaining flow until a node
+ * without outgoing flow, so if the flow is conserved at all inner nodes they lead from a network source to its sink.
+ * Like all paths, their arcs are stored from the sink to the source, such that a column taken first keeps its arcs unchanged.
+ * The flows are rounded to the nearest integer, the result does not depend on the order of the map.
+ * @return every path with its flow, with length zero and network_group -1
+ */
+std::vector<std::pair<Path, long>> decompose_arc_flow(const std::unordered_map<Arc, double>& arc_flow, const std::vector<std::vector<Arc>>& columns = {});
+
+/** Branching rule on the aggregated flow over single arcs, reconstructed from the path variables of the LP solution
+ * For an arc e with fractional flow f, the down branch bounds the flow over e by floor(f), the up branch by ceil(f) from below.
+ * Both decisions are local linear constraints over all path variables using e, stored in the DataManager so the pricer
+ * can add their dual prices to the edge weights (or forbid the edge if the flow is bounded by zero).
+ * Thereby the pricing problem remains a plain shortest path problem at every node.
+ * If all arc flows are integral while path variables are fractional, the arc flow is decomposed into integral paths,
+ * which form a solution with the same objective as the LP, so the node is solved without branching on path variables.
+ */
+class ObjBranchruleArcFlow : public scip::ObjBranchrule {
+	public:
+		ObjBranchruleArcFlow(SCIP * scip, const std::string branchrule_name, DataManager& data_manager);
+		virtual ~ObjBranchruleArcFlow();
+		virtual SCIP_DECL_BRANCHEXECLP(scip_execlp);
+		virtual SCIP_DECL_BRANCHEXITSOL(scip_exitsol);
+
+	private:
+		SCIP_RETCODE create_branch(SCIP * scip, const Arc& arc, double lhs, double rhs, const std::vector<SCIP_VAR *>& vars);
+		/// Creates a path variable of a decomposed arc flow, captured until the caller releases it
+		SCIP_RETCODE create_path_variable(SCIP * scip, Path path, SCIP_VAR ** var);
+		SCIP_RETCODE solve_integral_flow(SCIP * scip, const std::unordered_map<Arc, double>& arc_flow, SCIP_RESULT * result);
+
+		int n_branches_;
+		int n_path_variables_;
+		DataManager& data_manager_;
+};
+
+#endif
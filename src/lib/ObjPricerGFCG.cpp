@@ -24,21 +24,40 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <functional>
-#include <future>
+#include <limits>
 #include <memory>
+#include <unordered_map>
 
-#include <boost/asio.hpp>
-#include "loguru.hpp"
+#include "logging.hpp"
 #include <objscip/objscipdefplugins.h>
 
+#include "PerfCounters.hpp"
+#include "Trace.hpp"
+#include "memory_usage.hpp"
 
-ObjPricerGFCG::ObjPricerGFCG(SCIP * scip, const std::string pricer_name, DataManager& data_manager, boost::asio::thread_pool& tpool) :
+
+ObjPricerGFCG::ObjPricerGFCG(SCIP * scip, const std::string pricer_name, DataManager& data_manager, TaskPool& tpool) :
 	ObjPricer(scip, pricer_name.c_str(), "solve pricing problem by leveraging the graph structure of the lp", 0, TRUE),
 	n_generated_paths_(0),
 	n_iterations_(0),
 	data_manager_(data_manager),
-	tpool_(tpool) {
+	tpool_(tpool),
+	integer_paths_(false),
+	column_max_age_(0),
+	column_cleanup_interval_(1),
+	memory_report_interval_(0),
+	network_schedule_(1),
+	first_touch_(false),
+	parallel_network_min_edges_(0),
+	batch_identical_networks_(false),
+	network_batches_built_(false),
+	bound_pruning_(false),
+	recent_path_min_columns_(0),
+	recent_path_stage_(false),
+	recent_path_max_length_(0),
+	column_budget_(0) {
 		assert(scip != NULL);
 }
 
@@ -56,6 +75,53 @@ SCIP_DECL_PRICERINIT(ObjPricerGFCG::scip_init) {
 	return SCIP_OKAY;
 }
 
+/** Callback before the branch and bound data is freed
+ * Releases all path variables still captured for column aging.
+ */
+SCIP_DECL_PRICEREXITSOL(ObjPricerGFCG::scip_exitsol) {
+	assert(scip != NULL);
+	for (auto &column : columns_) {
+		SCIP_CALL( SCIPreleaseVar(scip, &column.var) );
+	}
+	columns_.clear();
+	return SCIP_OKAY;
+}
+
+void ObjPricerGFCG::set_column_aging(int max_age, int interval) {
+	assert(max_age >= 0);
+	assert(interval > 0);
+	column_max_age_ = max_age;
+	column_cleanup_interval_ = interval;
+}
+
+void ObjPricerGFCG::set_pricing_log(const std::string& filename) {
+	pricing_log_ = std::make_unique<PricingLog>(filename);
+}
+
+void ObjPricerGFCG::set_dual_trace(const std::string& filename) {
+	std::vector<std::string> constraint_names;
+	for (const auto &cons : data_manager_.get_constraints()) constraint_names.push_back(SCIPconsGetName(cons.scip_constraint));
+	dual_trace_ = std::make_unique<DualTraceWriter>(filename, constraint_names);
+}
+
+std::vector<Path> ObjPricerGFCG::replay_pricing(SCIP * scip, const std::vector<double>& duals) {
+	record_ = PricingRecord{};
+	zero_arc_weights();
+	apply_arc_weights(duals);
+
+	std::mutex paths_mutex;
+	std::vector<Path> paths;
+	price_columns(scip, [&](Path path) {
+		const std::lock_guard<std::mutex> lock(paths_mutex);
+		paths.push_back(std::move(path));
+		return SCIP_OKAY;
+	});
+	std::sort(paths.begin(), paths.end(), [](const Path& a, const Path& b) {
+		return a.network_group != b.network_group ? a.network_group < b.network_group : a.length < b.length;
+	});
+	return paths;
+}
+
 /** Pricing callback if the current problem instance was feasible in the last solving iteration */
 SCIP_DECL_PRICERREDCOST(ObjPricerGFCG::scip_redcost) {
 	/*
@@ -94,13 +160,18 @@ SCIP_DECL_PRICERFARKAS(ObjPricerGFCG::scip_farkas) {
 
 SCIP_RETCODE ObjPricerGFCG::zero_arc_weights() {
 	LOG_F(2, "Resetting all edge weights ...");
-	std::vector<std::future<void>> reset_weight_futures;
-	for (auto &net : data_manager_.get_networks()) {
-		auto task = std::make_shared<std::packaged_task<void()>> (std::bind(&Network::reset_edge_weights, std::ref(net.second)));
-		reset_weight_futures.push_back(std::move(task->get_future()));
-		boost::asio::post(tpool_, std::bind(&std::packaged_task<void()>::operator(), task));
+	const auto& networks = data_manager_.get_network_list();
+	if (network_schedule_ == 2) {
+		for_each_owned_network("zero_weights", [&](std::size_t i) {
+			TraceScope trace("zero_weights", networks[i]->get_group());
+			networks[i]->reset_edge_weights();
+		});
+		return SCIP_OKAY;
 	}
-	for (const auto& future : reset_weight_futures) future.wait();
+	tpool_.parallel_for("zero_weights", networks.size(), [&](std::size_t i) {
+		TraceScope trace("zero_weights", networks[i]->get_group());
+		networks[i]->reset_edge_weights();
+	});
 	return SCIP_OKAY;
 }
 
@@ -111,25 +182,69 @@ SCIP_RETCODE ObjPricerGFCG::zero_arc_weights() {
  * Since a y-variable y' might have been present in multiple constraints of the original problem, we sum up the contributions of each constraint.
  * */
 SCIP_RETCODE ObjPricerGFCG::set_arc_weights(SCIP * scip, bool farkas) {
-	LOG_F(2, "Getting dual solutions/farkas coefficients and updating edge weights ...");
-	std::vector<std::future<void>> set_weight_futures;
-	for (const auto &cons : data_manager_.get_constraints()) {
-		auto task = std::make_shared<std::packaged_task<void()>> ([&]() {
-			double dual_val = !farkas ? -SCIPgetDualsolLinear(scip, cons.scip_constraint) : -SCIPgetDualfarkasLinear(scip, cons.scip_constraint);
-			if (SCIPisZero(scip, dual_val)) return;
-			for (const auto &arc_info : cons.arcs) {
-				auto arc = arc_info.first;
-				auto coefficient = arc_info.second;
-				auto& net = data_manager_.get_network(arc);
-				net.add_to_edge_weight(arc, coefficient * dual_val);
-				DLOG_F(2, "Added weight %f to %s, new weight %d, group %i",
-						coefficient * dual_val, arc.to_string().c_str(), net.get_edge_weight(arc), net.get_group());
+	LOG_F(2, "Getting dual solutions/farkas coefficients ...");
+	const auto& constraints = data_manager_.get_constraints();
+	std::vector<double> duals(constraints.size(), 0.0);
+	int nonzero_duals = 0;
+	for (std::size_t i = 0; i < constraints.size(); i++) {
+		double dual_val = !farkas ? -SCIPgetDualsolLinear(scip, constraints[i].scip_constraint) : -SCIPgetDualfarkasLinear(scip, constraints[i].scip_constraint);
+		if (SCIPisZero(scip, dual_val)) continue;
+		duals[i] = dual_val;
+		nonzero_duals++;
+	}
+	record_.nonzero_duals = nonzero_duals;
+	if (dual_trace_) dual_trace_->write(farkas, duals);
+	apply_arc_weights(duals);
+	return SCIP_OKAY;
+}
+
+/** Add the contributions of the (negated) dual prices to the edge weights
+ * @param duals one value per constraint of the data manager, in the same order. Zero entries are skipped.
+ */
+void ObjPricerGFCG::apply_arc_weights(const std::vector<double>& duals) {
+	LOG_F(2, "Updating edge weights ...");
+	const auto& constraints = data_manager_.get_constraints();
+	assert(duals.size() == constraints.size());
+	if (network_schedule_ == 2) {
+		const auto& networks = data_manager_.get_network_list();
+		for_each_owned_network("set_weights", [&](std::size_t i) {
+			TraceScope trace("set_weights", networks[i]->get_group());
+			for (const auto &term : network_weight_terms_[i]) {
+				double dual_val = duals[term.constraint];
+				if (dual_val != 0.0) networks[i]->add_to_edge_weight(term.edge, term.coefficient * dual_val);
 			}
 		});
-		set_weight_futures.push_back(std::move(task->get_future()));
-		boost::asio::post(tpool_, std::bind(&std::packaged_task<void()>::operator(), task));
+		return;
+	}
+	if (constraint_weight_terms_.size() != constraints.size()) index_constraint_weight_terms();
+	tpool_.parallel_for("set_weights", constraints.size(), [&](std::size_t i) {
+		double dual_val = duals[i];
+		if (dual_val == 0.0) return;
+		TraceScope trace("set_weights", i);
+		for (const auto &term : constraint_weight_terms_[i]) {
+			term.network->add_to_edge_weight(term.edge, term.coefficient * dual_val);
+			DLOG_F(2, "Added weight %f to edge %u, group %i", term.coefficient * dual_val, term.edge, term.network->get_group());
+		}
+	});
+}
+
+/** Enforce the arc flow branching decisions that are active at the current node
+ * A branching constraint on arc e acts like a constraint of the original LP containing the y-variable of e with coefficient one,
+ * so its dual price is added to the weight of e. Forbidden edges are excluded afterwards, overriding any weight.
+ */
+SCIP_RETCODE ObjPricerGFCG::apply_arc_flow_branching(SCIP * scip, bool farkas) {
+	const auto& arc_flow_constraints = data_manager_.get_arc_flow_constraints();
+	for (const auto &cons : arc_flow_constraints) {
+		if (!SCIPconsIsActive(cons.scip_constraint)) continue;
+		double dual_val = !farkas ? -SCIPgetDualsolLinear(scip, cons.scip_constraint) : -SCIPgetDualfarkasLinear(scip, cons.scip_constraint);
+		if (SCIPisZero(scip, dual_val)) continue;
+		data_manager_.get_network(cons.arc).add_to_edge_weight(cons.arc, dual_val);
+	}
+	for (const auto &cons : arc_flow_constraints) {
+		if (!cons.forbidden || !SCIPconsIsActive(cons.scip_constraint)) continue;
+		DLOG_F(3, "Forbidding edge %s", cons.arc.format().c_str());
+		data_manager_.get_network(cons.arc).forbid_edge(cons.arc);
 	}
-	for (const auto& future : set_weight_futures) future.wait();
 	return SCIP_OKAY;
 }
 
@@ -141,7 +256,7 @@ SCIP_RETCODE ObjPricerGFCG::add_variable(SCIP * scip, SCIP_VAR * var, const std:
 		std::string cons_name(SCIPconsGetName(cons));
 		LOG_F(3, "Adding path variable (coefficient %f) to constraint %s", coefficient, cons_name.c_str());
 		#endif
-		scip_mutex.lock();
+		trace_lock(scip_mutex, "scip_mutex");
 		assert( SCIPconsIsModifiable(cons) );
 		SCIP_CALL( SCIPaddCoefLinear(scip, cons, var, coefficient) );
 		scip_mutex.unlock();
@@ -157,19 +272,24 @@ SCIP_RETCODE ObjPricerGFCG::add_variable(SCIP * scip, SCIP_VAR * var, const std:
  * Then, we add the newly generated variable to each of these constraints with the original coefficient of the corresponding y-variable.
  * */
 SCIP_RETCODE ObjPricerGFCG::generate_columns(SCIP * scip, Path path, std::mutex& scip_mutex) {
-	std::string varname = "p_" + std::to_string(n_generated_paths_);
+	auto start = std::chrono::steady_clock::now();
+	// fetch_add, such that concurrent workers never generate the same variable name
+	std::string varname = "p_" + std::to_string(n_generated_paths_++);
 	SCIP_VAR * var = NULL;
-	scip_mutex.lock();
+	trace_lock(scip_mutex, "scip_mutex");
 	SCIP_CALL( SCIPcreateVarBasic(
 				scip, &var, varname.c_str(),
 				0, // lower bound
 				SCIPinfinity(scip), // upper bound
 				0, // objective
-				SCIP_VARTYPE_CONTINUOUS) );
+				integer_paths_ ? SCIP_VARTYPE_INTEGER : SCIP_VARTYPE_CONTINUOUS) );
+	// variables need to be marked deletable before they are added to the problem
+	if (column_max_age_ > 0) SCIPvarMarkDeletable(var);
 	SCIP_CALL( SCIPaddPricedVar(scip, var, 1.0) );
+	if (column_max_age_ > 0) SCIP_CALL( SCIPcaptureVar(scip, var) );
 	scip_mutex.unlock();
 	for (const auto &arc : path.arcs) {
-		LOG_F(3, "Current edge (y-var): %s", arc.to_string().c_str());
+		LOG_F(3, "Current edge (y-var): %s", arc.format().c_str());
 		#ifndef NDEBUG
 		LOG_SCOPE_F(3, "Finding containing constraints ...");
 		#endif
@@ -180,10 +300,266 @@ SCIP_RETCODE ObjPricerGFCG::generate_columns(SCIP * scip, Path path, std::mutex&
 		// it->second is the vector of constraints for current lp_arc
 		add_variable(scip, var, constraints, scip_mutex);
 	}
+	// branching constraints need to contain the new variable even if they are not active at the current node
+	for (const auto &arc : path.arcs) {
+		auto branching_optional = data_manager_.get_arc_flow_constraints_of_arc(arc);
+		if (!branching_optional) continue;
+		add_variable(scip, var, *branching_optional, scip_mutex);
+	}
 
 	// in order to know the flow over arcs (y-vars) given the solution, keep track of arcs belonging to the current variable
 	data_manager_.add_var_path_pair(varname, path);
+	if (column_max_age_ > 0) {
+		const std::lock_guard<std::mutex> lock(columns_mutex_);
+		columns_.push_back(Column{var, 0});
+	}
 	SCIP_CALL( SCIPreleaseVar(scip, &var) );
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	const std::lock_guard<std::mutex> lock(record_mutex_);
+	record_.columns_ms += elapsed.count();
+	return SCIP_OKAY;
+}
+
+const Path& ObjPricerGFCG::price_network(Network& net, bool level_parallel) {
+	// every worker keeps its buffers across networks and iterations
+	thread_local ShortestPathScratch s_scratch;
+	const auto& path = level_parallel ? net.shortest_path(s_scratch, tpool_) : net.shortest_path(s_scratch);
+	const std::lock_guard<std::mutex> lock(record_mutex_);
+	record_.networks_priced++;
+	record_.min_reduced_cost = std::min(record_.min_reduced_cost, path.length);
+	return path;
+}
+
+SCIP_RETCODE ObjPricerGFCG::price_networks(const std::function<SCIP_RETCODE(const Path&)>& handle_path) {
+	if (recent_path_stage_) return price_recent_paths(handle_path);
+	const auto& networks = data_manager_.get_network_list();
+	if (large_network_flags_.size() != networks.size()) {
+		large_network_flags_.assign(networks.size(), false);
+		large_networks_.clear();
+		for (std::size_t i = 0; i < networks.size(); i++) {
+			if (parallel_network_min_edges_ <= 0 || networks[i]->get_edge_count() < parallel_network_min_edges_) continue;
+			large_network_flags_[i] = true;
+			large_networks_.push_back(i);
+		}
+		if (!large_networks_.empty()) LOG_F(1, "Pricing %zu large networks with level-parallel shortest paths", large_networks_.size());
+		network_batches_built_ = false;
+	}
+	if (batch_identical_networks_ && !network_batches_built_) {
+		std::vector<Network*> small_networks;
+		for (std::size_t i = 0; i < networks.size(); i++)
+			if (!large_network_flags_[i]) small_networks.push_back(networks[i]);
+		network_batches_ = NetworkBatch::make_batches(small_networks);
+		network_batches_built_ = true;
+		std::unordered_map<const Network*, std::size_t> network_index;
+		for (std::size_t i = 0; i < networks.size(); i++) network_index[networks[i]] = i;
+		network_batch_indices_.clear();
+		for (const auto& batch : network_batches_) {
+			network_batch_indices_.emplace_back();
+			for (auto net : batch.get_networks()) network_batch_indices_.back().push_back(network_index.at(net));
+		}
+		std::size_t n_batched = 0;
+		for (const auto& batch : network_batches_) n_batched += batch.get_networks().size();
+		LOG_F(1, "Pricing %zu networks with identical topology in %zu batches", n_batched, network_batches_.size());
+	}
+	network_bounds_.assign(networks.size(), std::numeric_limits<double>::quiet_NaN());
+	if (bound_pruning_) bound_networks();
+	// the recent paths of these networks became columns in the first stage, so they are not priced again
+	for (std::size_t i = 0; i < network_recent_negative_.size(); i++)
+		if (network_recent_negative_[i]) network_bounds_[i] = std::numeric_limits<double>::infinity();
+	auto pruned = [&](std::size_t i) { return !std::isnan(network_bounds_[i]); };
+
+	// large networks would bound the runtime of the sweep, so they are priced first, one after another by all workers
+	for (auto i : large_networks_) {
+		if (pruned(i)) {
+			SCIP_CALL( handle_path(bounded_path(i)) );
+			continue;
+		}
+		TraceScope trace("shortest_path_large", networks[i]->get_group());
+		SCIP_CALL( handle_path(price_network(*networks[i], true)) );
+	}
+
+	// the batches store their paths in the networks, so the sweep below only reports them
+	tpool_.parallel_for("shortest_path_batch", network_batches_.size(), [&](std::size_t b) {
+		TraceScope trace("shortest_path_batch", network_batches_[b].get_networks()[0]->get_group());
+		std::uint32_t skip_mask = 0;
+		for (std::size_t l = 0; l < network_batch_indices_[b].size(); l++)
+			if (pruned(network_batch_indices_[b][l])) skip_mask |= 1u << l;
+		network_batches_[b].shortest_paths(skip_mask);
+	});
+
+	// runtimes are only recorded for the cost model, whose plan sizes the table of the scheduler
+	bool cost_model = network_schedule_ == 1;
+	auto price = [&](std::size_t i) {
+		if (large_network_flags_[i]) return SCIP_OKAY;
+		if (pruned(i)) return handle_path(bounded_path(i));
+		TraceScope trace("shortest_path", networks[i]->get_group());
+		auto start = std::chrono::steady_clock::now();
+		const auto& path = price_network(*networks[i]);
+		if (cost_model)
+			scheduler_.record_runtime(i, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		return handle_path(path);
+	};
+	if (network_schedule_ == 0) return tpool_.parallel_for_status("shortest_path", networks.size(), SCIP_OKAY, price);
+
+	bool affine = network_schedule_ == 2;
+	if (affine) partition_networks();
+	else scheduler_.plan(networks, tpool_.get_thread_count());
+	const auto& batches = scheduler_.get_batches();
+	std::mutex status_mutex;
+	SCIP_RETCODE status = SCIP_OKAY;
+	std::atomic<bool> failed(false);
+	tpool_.parallel_for_queues("shortest_path", scheduler_.get_queues(), [&](std::size_t batch) {
+		for (auto i : batches[batch]) {
+			if (failed) return;
+			SCIP_RETCODE retcode = price(i);
+			if (retcode == SCIP_OKAY) continue;
+			const std::lock_guard<std::mutex> lock(status_mutex);
+			if (!failed.exchange(true)) status = retcode;
+		}
+	}, !affine);
+	return status;
+}
+
+SCIP_RETCODE ObjPricerGFCG::price_recent_paths(const std::function<SCIP_RETCODE(const Path&)>& handle_path) {
+	const auto& networks = data_manager_.get_network_list();
+	network_bounds_.assign(networks.size(), std::numeric_limits<double>::infinity());
+	auto price = [&](std::size_t i) {
+		TraceScope trace("recent_path", networks[i]->get_group());
+		// every network reports once, a placeholder if it has no recent path yet
+		const Path* path = networks[i]->shortest_recent_path();
+		if (!path) return handle_path(bounded_path(i));
+		{
+			const std::lock_guard<std::mutex> lock(record_mutex_);
+			record_.recent_paths_priced++;
+			record_.min_reduced_cost = std::min(record_.min_reduced_cost, path->length);
+		}
+		return handle_path(*path);
+	};
+	if (network_schedule_ != 2) return tpool_.parallel_for_status("recent_path", networks.size(), SCIP_OKAY, price);
+
+	// the recent paths are stored in the networks, which stay on their owning worker
+	std::mutex status_mutex;
+	SCIP_RETCODE status = SCIP_OKAY;
+	std::atomic<bool> failed(false);
+	for_each_owned_network("recent_path", [&](std::size_t i) {
+		if (failed) return;
+		SCIP_RETCODE retcode = price(i);
+		if (retcode == SCIP_OKAY) return;
+		const std::lock_guard<std::mutex> lock(status_mutex);
+		if (!failed.exchange(true)) status = retcode;
+	});
+	return status;
+}
+
+void ObjPricerGFCG::bound_networks() {
+	const auto& networks = data_manager_.get_network_list();
+	auto bound = [&](std::size_t i) {
+		if (networks[i]->is_shortest_path_fresh()) return;
+		double length_bound = networks[i]->length_bound();
+		if (length_bound >= 0) network_bounds_[i] = length_bound;
+	};
+	if (network_schedule_ == 2) for_each_owned_network("length_bound", bound);
+	else tpool_.parallel_for("length_bound", networks.size(), bound);
+	record_.networks_pruned = std::count_if(network_bounds_.begin(), network_bounds_.end(), [](double b) { return !std::isnan(b); });
+}
+
+const Path& ObjPricerGFCG::bounded_path(std::size_t network) {
+	thread_local Path s_path;
+	s_path.length = network_bounds_[network];
+	s_path.arcs.clear();
+	s_path.network_group = data_manager_.get_network_list()[network]->get_group();
+	return s_path;
+}
+
+void ObjPricerGFCG::partition_networks() {
+	const auto& networks = data_manager_.get_network_list();
+	if (!scheduler_.partition(networks, tpool_.get_thread_count())) return;
+	LOG_F(1, "Partitioning %zu networks among %d workers", networks.size(), tpool_.get_thread_count());
+
+	std::unordered_map<const Network*, std::size_t> network_index;
+	for (std::size_t i = 0; i < networks.size(); i++) network_index[networks[i]] = i;
+	network_weight_terms_.assign(networks.size(), std::vector<WeightTerm>());
+	const auto& constraints = data_manager_.get_constraints();
+	for (std::size_t c = 0; c < constraints.size(); c++) {
+		for (const auto &arc_info : constraints[c].arcs) {
+			auto i = network_index.at(&data_manager_.get_network(arc_info.first));
+			network_weight_terms_[i].push_back(WeightTerm{c, networks[i]->get_edge_index(arc_info.first), arc_info.second});
+		}
+	}
+
+	if (!first_touch_) return;
+	// the copy allocates the graph and maps on the owning worker, the original memory is released
+	for_each_owned_network("first_touch", [&](std::size_t i) {
+		networks[i]->reallocate();
+	});
+}
+
+void ObjPricerGFCG::index_constraint_weight_terms() {
+	const auto& constraints = data_manager_.get_constraints();
+	constraint_weight_terms_.assign(constraints.size(), std::vector<ConstraintWeightTerm>());
+	tpool_.parallel_for("index_weights", constraints.size(), [&](std::size_t c) {
+		for (const auto &arc_info : constraints[c].arcs) {
+			auto& net = data_manager_.get_network(arc_info.first);
+			constraint_weight_terms_[c].push_back(ConstraintWeightTerm{&net, net.get_edge_index(arc_info.first), arc_info.second});
+		}
+	});
+}
+
+void ObjPricerGFCG::for_each_owned_network(const char* phase, const std::function<void(std::size_t)>& body) {
+	partition_networks();
+	const auto& batches = scheduler_.get_batches();
+	tpool_.parallel_for_queues(phase, scheduler_.get_queues(), [&](std::size_t batch) {
+		for (auto i : batches[batch]) body(i);
+	}, false);
+}
+
+/** Age the columns and delete the stale ones every column_cleanup_interval_ iterations, if column aging is enabled
+ * Only called after feasible LP solves, since there is no primal solution to judge the columns by otherwise.
+ */
+SCIP_RETCODE ObjPricerGFCG::update_column_ages(SCIP * scip, SCIP_SOL * sol) {
+	if (column_max_age_ <= 0) return SCIP_OKAY;
+	SCIP_CALL( age_columns(scip, sol) );
+	if (n_iterations_ % column_cleanup_interval_ == 0) SCIP_CALL( remove_stale_columns(scip) );
+	return SCIP_OKAY;
+}
+
+/** Update the age of each generated column with the given solution
+ * A column is reset to age zero whenever it takes a positive value, otherwise it ages by one iteration.
+ */
+SCIP_RETCODE ObjPricerGFCG::age_columns(SCIP * scip, SCIP_SOL * sol) {
+	for (auto &column : columns_) {
+		if (SCIPisPositive(scip, SCIPgetSolVal(scip, sol, column.var))) {
+			column.age = 0;
+		} else {
+			column.age++;
+		}
+	}
+	return SCIP_OKAY;
+}
+
+/** Delete all columns which have been zero for more than column_max_age_ iterations
+ * The path records of the data manager are removed as well, the deleted variables will never appear in a solution.
+ * SCIP may refuse to delete a variable (e.g. if it is fixed by branching), in that case it is kept and checked again later.
+ */
+SCIP_RETCODE ObjPricerGFCG::remove_stale_columns(SCIP * scip) {
+	int n_deleted = 0;
+	std::vector<Column> kept_columns;
+	kept_columns.reserve(columns_.size());
+	for (auto &column : columns_) {
+		SCIP_Bool deleted = FALSE;
+		if (column.age > column_max_age_) SCIP_CALL( SCIPdelVar(scip, column.var, &deleted) );
+		if (!deleted) {
+			kept_columns.push_back(column);
+			continue;
+		}
+		DLOG_F(3, "Deleting stale path variable %s (age %d)", SCIPvarGetName(column.var), column.age);
+		data_manager_.remove_var_path_pair(SCIPvarGetName(column.var));
+		SCIP_CALL( SCIPreleaseVar(scip, &column.var) );
+		n_deleted++;
+	}
+	columns_ = std::move(kept_columns);
+	LOG_F(1, "Column aging deleted %d stale path variables, %zu remaining", n_deleted, columns_.size());
 	return SCIP_OKAY;
 }
 
@@ -191,16 +567,99 @@ SCIP_RETCODE ObjPricerGFCG::pricing(SCIP * scip, bool farkas) {
 	assert(scip != NULL);
 	LOG_SCOPE_F(1, "Pricing starts (%s), iteration %d ... ", !farkas ? "redcost" : "farkas", n_iterations_);
 	LOG_F(1, "Current primal bound: %f", SCIPgetPrimalbound(scip));
-	zero_arc_weights();
-	set_arc_weights(scip, farkas);
-	int generated_paths = shortest_path_cg(scip);
+	if (!farkas) SCIP_CALL( update_column_ages(scip, NULL) );
+	TraceScope trace(!farkas ? "pricing" : "pricing_farkas", n_iterations_);
+	record_ = PricingRecord{};
+	record_.iteration = n_iterations_;
+	record_.farkas = farkas;
+	record_.has_counters = g_perf_counters != nullptr;
+	// statistics of tasks that ran before this iteration are not part of it
+	tpool_.take_interval_summary();
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		CounterScope counters(record_.zero_weights_counters);
+		zero_arc_weights();
+	}
+	auto zeroed = std::chrono::steady_clock::now();
+	{
+		CounterScope counters(record_.set_weights_counters);
+		set_arc_weights(scip, farkas);
+		apply_arc_flow_branching(scip, farkas);
+	}
+	auto weighted = std::chrono::steady_clock::now();
+	int generated_paths;
+	{
+		CounterScope counters(record_.shortest_path_counters);
+		generated_paths = shortest_path_cg(scip);
+	}
+	auto priced = std::chrono::steady_clock::now();
+
+	record_.zero_weights_ms = std::chrono::duration<double, std::milli>(zeroed - start).count();
+	record_.set_weights_ms = std::chrono::duration<double, std::milli>(weighted - zeroed).count();
+	record_.shortest_path_ms = std::chrono::duration<double, std::milli>(priced - weighted).count();
+	record_.total_ms = std::chrono::duration<double, std::milli>(priced - start).count();
+	record_.columns_added = generated_paths;
+	// there is no LP objective if the LP was infeasible
+	if (!farkas) record_.lp_objective = SCIPgetLPObjval(scip);
+	record_.pool_utilization = tpool_.get_interval_utilization();
+	record_.pool_phases = tpool_.take_interval_summary();
+	if (pricing_log_) pricing_log_->write(record_);
 
 	LOG_F(1, "Completed pricing, generated %d new paths/variables", generated_paths);
+	if (memory_report_interval_ > 0 && n_iterations_ % memory_report_interval_ == 0)
+		log_memory_usage(data_manager_, "pricing iteration " + std::to_string(n_iterations_));
 	n_iterations_ += 1;
 	return SCIP_OKAY;
 }
 
-// TODO threading
+void ObjPricerGFCG::set_recent_path_min_columns(int min_columns) {
+	int limit = get_column_limit();
+	if (limit > 0 && min_columns > limit) {
+		LOG_F(WARNING, "recent_path_min_columns %d exceeds the %d columns of the pricer per iteration, using %d", min_columns, limit, limit);
+		min_columns = limit;
+	}
+	recent_path_min_columns_ = min_columns;
+}
+
+/** Runs select_columns on the recent paths of the networks and, if they yield fewer than recent_path_min_columns_ columns, on the shortest paths
+ * The second stage skips the networks that got a column in the first, and may only add the rest of the column limit of the pricer.
+ */
+int ObjPricerGFCG::price_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column) {
+	int limit = get_column_limit();
+	column_budget_ = limit;
+	if (recent_path_min_columns_ <= 0) return select_columns(scip, add_column);
+
+	const auto& networks = data_manager_.get_network_list();
+	if (group_network_index_.size() != networks.size()) {
+		group_network_index_.clear();
+		for (std::size_t i = 0; i < networks.size(); i++) group_network_index_[networks[i]->get_group()] = i;
+	}
+	network_recent_negative_.assign(networks.size(), false);
+	recent_path_max_length_ = -SCIPepsilon(scip);
+	recent_path_stage_ = true;
+	// every network reports at most one recent path, so each flag is written by one worker only
+	int selected = select_columns(scip, [&](Path path) {
+		network_recent_negative_[group_network_index_.at(path.network_group)] = true;
+		return add_column(std::move(path));
+	});
+	recent_path_stage_ = false;
+	record_.recent_path_columns = selected;
+
+	// the minimum is at most the limit, so there is budget left whenever the second stage runs
+	if (selected < recent_path_min_columns_) {
+		column_budget_ = limit - selected;
+		selected += select_columns(scip, add_column);
+	}
+	network_recent_negative_.clear();
+	return selected;
+}
+
+int ObjPricerGFCG::shortest_path_cg(SCIP * scip) {
+	std::mutex scip_mutex;
+	return price_columns(scip, [&](Path path) { return generate_columns(scip, std::move(path), scip_mutex); });
+}
+
 SCIP_RETCODE ObjPricerGFCG::update_constraint_pointers(SCIP * scip) {
 	LOG_F(3, "Updating constraint pointers after presolve");
 	for (auto &cons : data_manager_.get_constraints()) {
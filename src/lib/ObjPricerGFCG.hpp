@@ -23,13 +23,23 @@
 #ifndef __OBJPRICERGFCG_HPP
 #define __OBJPRICERGFCG_HPP
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <objscip/objscip.h>
 
 #include "DataManager.hpp"
+#include "DualTrace.hpp"
+#include "NetworkBatch.hpp"
+#include "NetworkScheduler.hpp"
+#include "Path.hpp"
+#include "PricingLog.hpp"
+#include "TaskPool.hpp"
 
 /** Provides callbacks for the SCIP framework in order to generate new variables after each solving iteration
  * This is the main component of the Halligalli GFCG library.
@@ -38,26 +48,162 @@
  */
 class ObjPricerGFCG : public scip::ObjPricer {
 	public:
-		ObjPricerGFCG(SCIP * scip, const std::string pricer_name, DataManager& data_manager, boost::asio::thread_pool& tpool);
+		ObjPricerGFCG(SCIP * scip, const std::string pricer_name, DataManager& data_manager, TaskPool& tpool);
 		virtual ~ObjPricerGFCG();
 		virtual SCIP_DECL_PRICERINIT(scip_init);
+		virtual SCIP_DECL_PRICEREXITSOL(scip_exitsol);
 		virtual SCIP_DECL_PRICERREDCOST(scip_redcost);
 		virtual SCIP_DECL_PRICERFARKAS(scip_farkas);
 
+		/** Enables removal of path variables that stayed at zero for more than max_age reduced cost iterations, checked every interval iterations
+		 * A max_age of zero disables column aging. Requires the SCIP parameters pricing/delvars and pricing/delvarsroot to be set.
+		 */
+		void set_column_aging(int max_age, int interval);
+		/// Generated path variables are integer instead of continuous, for solving the integer variant of the problem
+		void set_integer_paths(bool integer_paths) { integer_paths_ = integer_paths; }
+		/// Adds the dual prices (one per constraint of the data manager) to the edge weights, independently of the SCIP LP
+		void apply_arc_weights(const std::vector<double>& duals);
+		/// Writes statistics of every pricing iteration as JSON lines to the given file
+		void set_pricing_log(const std::string& filename);
+		/// Records the dual prices of every pricing call to a binary dual trace, see DualTraceWriter
+		void set_dual_trace(const std::string& filename);
+		/** Prices all networks under the given dual prices without the SCIP LP, e.g. to replay a recorded dual trace
+		 * Follows the pricing strategy and all pricing options, but the selected paths are returned instead of added as variables.
+		 * @return the paths that would become columns, ordered by network group and length
+		 */
+		std::vector<Path> replay_pricing(SCIP * scip, const std::vector<double>& duals);
+		/// Logs the memory usage of the process and the data manager every interval pricing iterations, zero disables it
+		void set_memory_report_interval(int interval) { memory_report_interval_ = interval; }
+		/** How the weight updates and shortest path computations are distributed among the workers
+		 * 0: networks in load order, split into equal chunks. 1: batches by estimated cost with work stealing, see NetworkScheduler.
+		 * 2: static partition balanced by size, each network is reset, weighted and priced by the same worker in every iteration
+		 */
+		void set_network_schedule(int schedule) { network_schedule_ = schedule; }
+		/// Networks with at least this many edges are priced one at a time with a level-parallel shortest path, zero disables it
+		void set_parallel_network_min_edges(int min_edges) { parallel_network_min_edges_ = min_edges; large_network_flags_.clear(); }
+		/// Price networks with identical topology together in vectorized sweeps, see NetworkBatch
+		void set_batch_identical_networks(bool batch) { batch_identical_networks_ = batch; network_batches_built_ = false; network_batches_.clear(); }
+		/// Skip the shortest path computation of networks whose lower bound on the path length (see Network::length_bound) is nonnegative
+		void set_bound_pruning(bool bound_pruning) { bound_pruning_ = bound_pruning; }
+		/** Price the recent shortest paths of every network (see Network::shortest_recent_path) before the exact shortest paths
+		 * The exact shortest paths are only computed if this yields fewer than min_columns columns, zero disables it.
+		 * min_columns is reduced to the column limit of the pricer (see get_column_limit) if it exceeds it.
+		 */
+		void set_recent_path_min_columns(int min_columns);
+		/// With network schedule 2, copy every network once on its owning worker, so its memory is first touched on that worker's memory node
+		void set_first_touch(bool first_touch) { first_touch_ = first_touch; }
+
 	protected:
+		/// A generated path variable and the number of reduced cost iterations since it last had a positive value in the LP solution
+		struct Column {
+			SCIP_VAR * var;
+			int age;
+		};
+		/// Contribution of the dual price of a constraint to the weight of an edge (see Network::get_edge_index) of one network
+		struct WeightTerm {
+			std::size_t constraint;
+			std::uint32_t edge;
+			double coefficient;
+		};
+		/// Contribution of the dual price of a constraint to the weight of an edge, for the weight update by constraint
+		struct ConstraintWeightTerm {
+			Network * network;
+			std::uint32_t edge;
+			double coefficient;
+		};
+
+
 		SCIP_RETCODE pricing(SCIP * scip, bool farkas);
-		/** This function decides which paths are to be added as variables and should be implemented by derived classes, depending on the pricing strategy */
-		virtual int shortest_path_cg(SCIP * scip) = 0;
+		/** This function decides which of the paths reported by price_networks are to be added as variables and should be implemented by derived classes, depending on the pricing strategy
+		 * add_column is called concurrently with every selected path.
+		 * @return the number of selected paths
+		 */
+		virtual int select_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column) = 0;
+		/// The maximal number of columns select_columns adds in one pricing iteration, zero if unlimited
+		virtual int get_column_limit() const { return 0; }
+		/// Runs select_columns, on the recent paths first if enabled (see set_recent_path_min_columns)
+		int price_columns(SCIP * scip, const std::function<SCIP_RETCODE(Path)>& add_column);
+		/// Prices all networks and adds the selected paths as variables
+		int shortest_path_cg(SCIP * scip);
 		SCIP_RETCODE update_constraint_pointers(SCIP * scip);
 		SCIP_RETCODE zero_arc_weights();
 		SCIP_RETCODE set_arc_weights(SCIP * scip, bool farkas);
+		SCIP_RETCODE apply_arc_flow_branching(SCIP * scip, bool farkas);
 		SCIP_RETCODE add_variable(SCIP * scip, SCIP_VAR * var, const std::vector<DataManager::constraint_data_t>& constraints_data, std::mutex& scip_mutex);
 		SCIP_RETCODE generate_columns(SCIP * scip, Path path, std::mutex& scip_mutex);
+		/** Computes the shortest path of a network with the scratch buffers of the calling thread and records it in the statistics of the current iteration
+		 * @param level_parallel relax the levels of the network in parallel on the pool, only from outside the pool
+		 * @return the path cached in the network, copies are only needed for paths that become columns
+		 */
+		const Path& price_network(Network& net, bool level_parallel = false);
+		/// Computes the length bounds of all networks with stale paths and marks those which can not have a negative path
+		void bound_networks();
+		/// Stands in for the shortest path of a network without negative path, the reference is valid until the next call on the same thread
+		const Path& bounded_path(std::size_t network);
+		/** Computes the shortest path of every network on the pool, following the network schedule
+		 * handle_path is called concurrently with each path as soon as it is computed, the reference is valid during the call.
+		 * @return SCIP_OKAY, or the first other code returned by handle_path, after which no further networks are priced
+		 */
+		SCIP_RETCODE price_networks(const std::function<SCIP_RETCODE(const Path&)>& handle_path);
+		/// Reports the shortest recent path of every network to handle_path instead of its shortest path, following the network schedule
+		SCIP_RETCODE price_recent_paths(const std::function<SCIP_RETCODE(const Path&)>& handle_path);
+		/// Computes the static partition of network schedule 2 and the weight terms of every network, once
+		void partition_networks();
+		/// Looks up the edges of the arcs of every constraint, once
+		void index_constraint_weight_terms();
+		/// Runs body(network index) for every network on the worker owning it under network schedule 2
+		void for_each_owned_network(const char* phase, const std::function<void(std::size_t)>& body);
+		/// Ages the columns with the given solution (NULL for the current LP solution) and deletes the stale ones, see set_column_aging
+		SCIP_RETCODE update_column_ages(SCIP * scip, SCIP_SOL * sol);
+		SCIP_RETCODE age_columns(SCIP * scip, SCIP_SOL * sol);
+		SCIP_RETCODE remove_stale_columns(SCIP * scip);
 
-		int n_generated_paths_;
+		std::atomic<int> n_generated_paths_;
 		int n_iterations_;
 		DataManager& data_manager_;
-		boost::asio::thread_pool& tpool_;
+		TaskPool& tpool_;
+
+		bool integer_paths_;
+		int column_max_age_;
+		int column_cleanup_interval_;
+		int memory_report_interval_;
+		int network_schedule_;
+		bool first_touch_;
+		NetworkScheduler scheduler_;
+		int parallel_network_min_edges_;
+		/// networks priced before the sweep by a level-parallel shortest path, by position in the network list
+		std::vector<std::size_t> large_networks_;
+		std::vector<bool> large_network_flags_;
+		bool batch_identical_networks_;
+		bool network_batches_built_;
+		/// batches of the networks with identical topology, except large networks, and the positions of their networks in the network list
+		std::vector<NetworkBatch> network_batches_;
+		std::vector<std::vector<std::size_t>> network_batch_indices_;
+		bool bound_pruning_;
+		/// lower bound of every network with nonnegative bound in the current iteration, infinity for networks that are not priced otherwise, NaN for the others
+		std::vector<double> network_bounds_;
+		int recent_path_min_columns_;
+		/// if price_networks reports the recent paths instead of the shortest paths, set during the first pricing stage
+		bool recent_path_stage_;
+		/// paths shorter than this are columns, the negative epsilon of SCIP
+		double recent_path_max_length_;
+		/// networks whose recent path became a column in the first pricing stage and which are not priced again in the second
+		std::vector<char> network_recent_negative_;
+		/// position in the network list of every network group, to mark the networks of the columns of the first stage
+		std::unordered_map<int, std::size_t> group_network_index_;
+		/// columns select_columns may add in the current stage if the pricer has a column limit, the rest of the limit after the first stage
+		int column_budget_;
+		/// weight terms of every network (by position in the network list), grouped for the thread-affine weight update
+		std::vector<std::vector<WeightTerm>> network_weight_terms_;
+		/// weight terms of every constraint, such that the weight update does not look up arcs
+		std::vector<std::vector<ConstraintWeightTerm>> constraint_weight_terms_;
+		std::mutex columns_mutex_;
+		std::vector<Column> columns_;
+
+		std::mutex record_mutex_;
+		PricingRecord record_;
+		std::unique_ptr<PricingLog> pricing_log_;
+		std::unique_ptr<DualTraceWriter> dual_trace_;
 };
 
 #endif
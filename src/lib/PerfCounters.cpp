@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PerfCounters.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "logging.hpp"
+
+PerfCounters* g_perf_counters = nullptr;
+
+static const double c_unavailable = std::numeric_limits<double>::quiet_NaN();
+
+CounterValues CounterValues::operator-(const CounterValues& rhs) const {
+	return CounterValues{cycles - rhs.cycles, instructions - rhs.instructions, llc_misses - rhs.llc_misses, branch_misses - rhs.branch_misses};
+}
+
+#ifdef __linux__
+static int open_counter(std::uint64_t config, const char* name) {
+	struct perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	// user space only, which is permitted with the default perf_event_paranoid setting
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.inherit = 1;
+	int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	if (fd < 0) LOG_F(WARNING, "Hardware counter %s is not available (%s)", name, std::strerror(errno));
+	return fd;
+}
+#endif
+
+PerfCounters::PerfCounters() {
+	fds_.fill(-1);
+#ifdef __linux__
+	fds_[0] = open_counter(PERF_COUNT_HW_CPU_CYCLES, "cycles");
+	fds_[1] = open_counter(PERF_COUNT_HW_INSTRUCTIONS, "instructions");
+	// the generic cache miss event counts last level cache misses on most CPUs
+	fds_[2] = open_counter(PERF_COUNT_HW_CACHE_MISSES, "LLC misses");
+	fds_[3] = open_counter(PERF_COUNT_HW_BRANCH_MISSES, "branch misses");
+#else
+	LOG_F(WARNING, "Hardware counters are only supported on Linux");
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+	for (auto fd : fds_) if (fd >= 0) close(fd);
+#endif
+}
+
+bool PerfCounters::is_available() const {
+	for (auto fd : fds_) if (fd >= 0) return true;
+	return false;
+}
+
+double PerfCounters::read_counter(int fd) const {
+#ifdef __linux__
+	if (fd < 0) return c_unavailable;
+	std::uint64_t values[3];
+	if (::read(fd, values, sizeof(values)) != sizeof(values)) return c_unavailable;
+	// values: count, time enabled, time running
+	if (values[2] == 0) return 0.0;
+	return static_cast<double>(values[0]) * values[1] / values[2];
+#else
+	return c_unavailable;
+#endif
+}
+
+CounterValues PerfCounters::read() const {
+	return CounterValues{read_counter(fds_[0]), read_counter(fds_[1]), read_counter(fds_[2]), read_counter(fds_[3])};
+}
+
+void log_counters(const std::string& phase, const CounterValues& values) {
+	LOG_F(INFO, "Hardware counters of %s: %.0f cycles, %.0f instructions (IPC %.2f), %.0f LLC misses, %.0f branch misses",
+			phase.c_str(), values.cycles, values.instructions, values.instructions / values.cycles, values.llc_misses, values.branch_misses);
+}
+
+CounterScope::CounterScope(CounterValues& total) :
+	total_(total) {
+	if (g_perf_counters) start_ = g_perf_counters->read();
+}
+
+CounterScope::~CounterScope() {
+	if (!g_perf_counters) return;
+	auto delta = g_perf_counters->read() - start_;
+	total_.cycles += delta.cycles;
+	total_.instructions += delta.instructions;
+	total_.llc_misses += delta.llc_misses;
+	total_.branch_misses += delta.branch_misses;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __PERFCOUNTERS_HPP
+#define __PERFCOUNTERS_HPP
+
+#include <array>
+#include <string>
+
+/** Values of the hardware counters, NaN for counters that are not available */
+struct CounterValues {
+	double cycles;
+	double instructions;
+	double llc_misses;
+	double branch_misses;
+
+	CounterValues operator-(const CounterValues& rhs) const;
+};
+
+/** Hardware performance counters of the whole process, read via perf_event_open (Linux only)
+ * The counters are inherited by all threads created after construction, so they have to be opened before the thread pool
+ * is created in order to include its workers. Reading them at the beginning and end of a phase yields the cost of the phase,
+ * as long as no other phase runs concurrently. Counters which can not be opened (unsupported by the CPU or hypervisor,
+ * or forbidden by kernel.perf_event_paranoid) read as NaN, all other counters keep working.
+ */
+class PerfCounters {
+	public:
+		PerfCounters();
+		~PerfCounters();
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator=(const PerfCounters&) = delete;
+
+		/// True if at least one counter could be opened
+		bool is_available() const;
+		/// Current counter values since construction, scaled up if the kernel had to multiplex the counters
+		CounterValues read() const;
+
+	private:
+		double read_counter(int fd) const;
+
+		std::array<int, 4> fds_;
+};
+
+/// Writes the counter values of a phase to the log
+void log_counters(const std::string& phase, const CounterValues& values);
+
+/// The active hardware counters, nullptr if disabled
+extern PerfCounters* g_perf_counters;
+
+/** Measures the hardware counters of the active PerfCounters over the lifetime of the scope and adds them to a total */
+class CounterScope {
+	public:
+		CounterScope(CounterValues& total);
+		~CounterScope();
+
+	private:
+		CounterValues& total_;
+		CounterValues start_;
+};
+
+#endif
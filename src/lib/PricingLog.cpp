@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PricingLog.hpp"
+
+#include <cmath>
+
+#include <nlohmann/json.hpp>
+#include "logging.hpp"
+
+using json = nlohmann::json;
+
+PricingLog::PricingLog(const std::string& filename) :
+	file_(filename) {
+	if (!file_) ABORT_F("Unable to open pricing log %s", filename.c_str());
+}
+
+static json counters_to_json(const CounterValues& values) {
+	auto value = [](double v) { return std::isfinite(v) ? json(v) : json(nullptr); };
+	return {
+		{"cycles", value(values.cycles)},
+		{"instructions", value(values.instructions)},
+		{"llc_misses", value(values.llc_misses)},
+		{"branch_misses", value(values.branch_misses)}
+	};
+}
+
+void PricingLog::write(const PricingRecord& record) {
+	json line = {
+		{"iteration", record.iteration},
+		{"farkas", record.farkas},
+		{"total_ms", record.total_ms},
+		{"zero_weights_ms", record.zero_weights_ms},
+		{"set_weights_ms", record.set_weights_ms},
+		{"shortest_path_ms", record.shortest_path_ms},
+		{"columns_ms", record.columns_ms},
+		{"nonzero_duals", record.nonzero_duals},
+		{"networks_priced", record.networks_priced},
+		{"networks_pruned", record.networks_pruned},
+		{"recent_paths_priced", record.recent_paths_priced},
+		{"recent_path_columns", record.recent_path_columns},
+		{"columns_added", record.columns_added}
+	};
+	// infinite and undefined values have no JSON representation
+	line["min_reduced_cost"] = std::isfinite(record.min_reduced_cost) ? json(record.min_reduced_cost) : json(nullptr);
+	line["lp_objective"] = std::isfinite(record.lp_objective) ? json(record.lp_objective) : json(nullptr);
+	line["pool_utilization"] = record.pool_utilization;
+	line["pool_phases"] = json::array();
+	for (const auto &phase : record.pool_phases) {
+		line["pool_phases"].push_back({
+			{"phase", phase.phase},
+			{"tasks", phase.tasks},
+			{"wait_p50_us", phase.wait_p50_us},
+			{"wait_p99_us", phase.wait_p99_us},
+			{"wait_max_us", phase.wait_max_us},
+			{"run_p50_us", phase.run_p50_us},
+			{"run_p99_us", phase.run_p99_us},
+			{"run_max_us", phase.run_max_us},
+			{"busy_ms", phase.busy_ms}
+		});
+	}
+	if (record.has_counters) {
+		line["counters"] = {
+			{"zero_weights", counters_to_json(record.zero_weights_counters)},
+			{"set_weights", counters_to_json(record.set_weights_counters)},
+			{"shortest_path", counters_to_json(record.shortest_path_counters)}
+		};
+	}
+	file_ << line.dump() << "\n";
+	file_.flush();
+}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __PRICINGLOG_HPP
+#define __PRICINGLOG_HPP
+
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.hpp"
+#include "TaskPool.hpp"
+
+/** Statistics of a single pricing iteration
+ * Phase times are wall times in milliseconds. Since workers insert columns while other networks are still being priced,
+ * columns_ms is the time spent in column insertion summed over all workers, and is contained in shortest_path_ms.
+ */
+struct PricingRecord {
+	int iteration = 0;
+	bool farkas = false;
+	double total_ms = 0;
+	double zero_weights_ms = 0;
+	double set_weights_ms = 0;
+	double shortest_path_ms = 0;
+	double columns_ms = 0;
+	int nonzero_duals = 0;
+	int networks_priced = 0;
+	/// networks skipped because their lower bound on the path length was nonnegative
+	int networks_pruned = 0;
+	/// networks with a recent path evaluated before computing the exact shortest paths, see recent_path_columns
+	int recent_paths_priced = 0;
+	/// columns found among the recent paths of the networks, before computing the exact shortest paths
+	int recent_path_columns = 0;
+	double min_reduced_cost = std::numeric_limits<double>::infinity();
+	int columns_added = 0;
+	double lp_objective = std::numeric_limits<double>::quiet_NaN();
+	/// fraction of the worker time of the iteration spent running tasks
+	double pool_utilization = 0;
+	std::vector<PhaseSummary> pool_phases;
+	/// hardware counters of the phases, only valid if has_counters is set
+	bool has_counters = false;
+	CounterValues zero_weights_counters = {0, 0, 0, 0};
+	CounterValues set_weights_counters = {0, 0, 0, 0};
+	CounterValues shortest_path_counters = {0, 0, 0, 0};
+};
+
+/** Writes one JSON object per pricing iteration to a file (JSON lines) */
+class PricingLog {
+	public:
+		PricingLog(const std::string& filename);
+
+		void write(const PricingRecord& record);
+
+	private:
+		std::ofstream file_;
+};
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TaskPool.hpp"
+
+#include <assert.h>
+#include <numeric>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "logging.hpp"
+
+TaskPool::TaskPool(int n_threads) :
+	n_threads_(n_threads),
+	pool_(n_threads),
+	n_workers_seen_(0),
+	busy_ns_(n_threads),
+	interval_busy_ns_(n_threads),
+	created_(clock::now()),
+	interval_start_(created_) {
+	assert(n_threads > 0);
+	for (int i = 0; i < n_threads; i++) {
+		busy_ns_[i] = 0;
+		interval_busy_ns_[i] = 0;
+	}
+}
+
+TaskPool::TaskTimer::TaskTimer(TaskPool& pool, PhaseStats& stats, clock::time_point enqueued) :
+	pool_(pool),
+	stats_(stats),
+	start_(clock::now()) {
+	std::uint64_t wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start_ - enqueued).count();
+	stats_.wait.record(wait_ns);
+	stats_.interval_wait.record(wait_ns);
+}
+
+TaskPool::TaskTimer::~TaskTimer() {
+	std::uint64_t run_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_).count();
+	stats_.run.record(run_ns);
+	stats_.interval_run.record(run_ns);
+	int worker = pool_.get_worker_index();
+	pool_.busy_ns_[worker].fetch_add(run_ns, std::memory_order_relaxed);
+	pool_.interval_busy_ns_[worker].fetch_add(run_ns, std::memory_order_relaxed);
+}
+
+bool TaskPool::pin_workers() {
+#ifdef __linux__
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+	std::vector<int> cpus;
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+	if (cpus.empty()) return false;
+
+	// every task waits for all others to start, so each one runs on a different worker
+	Latch started(n_threads_);
+	Latch done(n_threads_);
+	std::atomic<int> n_pinned(0);
+	for (int t = 0; t < n_threads_; t++) {
+		boost::asio::post(pool_, [&]() {
+			started.count_down();
+			started.wait();
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET(cpus[get_worker_index() % cpus.size()], &cpu_set);
+			if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0) n_pinned++;
+			done.count_down();
+		});
+	}
+	done.wait();
+	LOG_F(1, "Pinned %d of %d workers to %zu allowed CPUs", n_pinned.load(), n_threads_, cpus.size());
+	return n_pinned == n_threads_;
+#else
+	return false;
+#endif
+}
+
+void TaskPool::join() {
+	pool_.join();
+}
+
+int TaskPool::get_thread_count() const {
+	return n_threads_;
+}
+
+TaskPool::PhaseStats& TaskPool::get_phase_stats(const char* phase) {
+	const std::lock_guard<std::mutex> lock(phases_mutex_);
+	auto& stats = phases_[phase];
+	if (!stats) stats = std::make_unique<PhaseStats>();
+	return *stats;
+}
+
+/** Workers are numbered in the order they run their first task */
+int TaskPool::get_worker_index() {
+	thread_local TaskPool* s_owner = nullptr;
+	thread_local int s_index = 0;
+	if (s_owner != this) {
+		s_index = n_workers_seen_++;
+		s_owner = this;
+	}
+	assert(s_index < n_threads_);
+	return s_index;
+}
+
+std::vector<PhaseSummary> TaskPool::summarize(const std::map<std::string, std::unique_ptr<PhaseStats>>& phases, bool interval) {
+	std::vector<PhaseSummary> summaries;
+	for (const auto &pair : phases) {
+		const auto& wait = interval ? pair.second->interval_wait : pair.second->wait;
+		const auto& run = interval ? pair.second->interval_run : pair.second->run;
+		if (run.get_count() == 0) continue;
+		summaries.push_back(PhaseSummary{
+			pair.first,
+			run.get_count(),
+			wait.get_percentile(50) / 1e3,
+			wait.get_percentile(99) / 1e3,
+			wait.get_max() / 1e3,
+			run.get_percentile(50) / 1e3,
+			run.get_percentile(99) / 1e3,
+			run.get_max() / 1e3,
+			run.get_sum() / 1e6
+		});
+	}
+	return summaries;
+}
+
+std::vector<PhaseSummary> TaskPool::get_summary() {
+	const std::lock_guard<std::mutex> lock(phases_mutex_);
+	return summarize(phases_, false);
+}
+
+std::vector<PhaseSummary> TaskPool::take_interval_summary() {
+	const std::lock_guard<std::mutex> lock(phases_mutex_);
+	auto summaries = summarize(phases_, true);
+	for (auto &pair : phases_) {
+		pair.second->interval_wait.clear();
+		pair.second->interval_run.clear();
+	}
+	for (auto &busy : interval_busy_ns_) busy = 0;
+	interval_start_ = clock::now();
+	return summaries;
+}
+
+double TaskPool::get_interval_utilization() const {
+	double available_ns = std::chrono::duration<double, std::nano>(clock::now() - interval_start_).count() * n_threads_;
+	double busy_ns = std::accumulate(interval_busy_ns_.begin(), interval_busy_ns_.end(), 0.0);
+	return available_ns > 0 ? busy_ns / available_ns : 0.0;
+}
+
+void TaskPool::log_summary() {
+	LOG_SCOPE_F(INFO, "Thread pool statistics (%d threads)", n_threads_);
+	for (const auto &summary : get_summary()) {
+		LOG_F(INFO, "%-16s %8llu tasks, queue wait p50 %.1fus p99 %.1fus max %.1fus, runtime p50 %.1fus p99 %.1fus max %.1fus, busy %.1fms",
+				summary.phase.c_str(), static_cast<unsigned long long>(summary.tasks), summary.wait_p50_us, summary.wait_p99_us, summary.wait_max_us,
+				summary.run_p50_us, summary.run_p99_us, summary.run_max_us, summary.busy_ms);
+	}
+	double elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - created_).count();
+	for (int i = 0; i < n_threads_; i++) {
+		double busy_ms = busy_ns_[i] / 1e6;
+		LOG_F(INFO, "worker %3d busy %.1fms (%.1f%%)", i, busy_ms, elapsed_ms > 0 ? 100.0 * busy_ms / elapsed_ms : 0.0);
+	}
+}
@@ -0,0 +1,343 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __TASKPOOL_HPP
+#define __TASKPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include "Histogram.hpp"
+
+/** Queueing and runtime statistics of the tasks of one phase, times in microseconds */
+struct PhaseSummary {
+	std::string phase;
+	std::uint64_t tasks;
+	double wait_p50_us;
+	double wait_p99_us;
+	double wait_max_us;
+	double run_p50_us;
+	double run_p99_us;
+	double run_max_us;
+	/// summed runtime of all tasks
+	double busy_ms;
+};
+
+/** Blocks until it has been counted down a given number of times */
+class Latch {
+	public:
+		Latch(std::size_t count) : count_(count) {}
+
+		void count_down() {
+			const std::lock_guard<std::mutex> lock(mutex_);
+			if (--count_ == 0) zero_.notify_all();
+		}
+
+		void wait() {
+			std::unique_lock<std::mutex> lock(mutex_);
+			zero_.wait(lock, [this]() { return count_ == 0; });
+		}
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable zero_;
+		std::size_t count_;
+};
+
+/** Thread pool executing the parallel phases of the solver
+ * Wraps a boost::asio::thread_pool and measures, per phase, how long tasks wait in the queue and how long they run,
+ * as well as the busy time of every worker. Statistics are kept for the whole run and for the current interval,
+ * which lets the pricer report the pool utilization of each iteration.
+ */
+class TaskPool {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		TaskPool(int n_threads);
+
+		/** Run a task on the pool
+		 * @param phase name of the phase the task belongs to, should be a string literal
+		 * @return future holding the result (or exception) of the task
+		 */
+		template<typename F>
+		auto submit(const char* phase, F task) -> std::future<decltype(task())>;
+
+		/** Run body(i) for all i in [0, n) on the pool and wait for completion (fork-join)
+		 * The range is split into chunks of consecutive indices, which at most one task per worker claims one after another,
+		 * so no allocation happens per index. The first exception thrown by body is rethrown after all workers stopped.
+		 * Blocks the calling thread, so it must not be called from a task of the same pool.
+		 * @param chunk_size indices per chunk, 0 picks a size yielding about c_chunks_per_thread chunks per worker
+		 */
+		template<typename F>
+		void parallel_for(const char* phase, std::size_t n, F body, std::size_t chunk_size = 0);
+		/** Like parallel_for, but body returns a status, e.g. SCIP_RETCODE
+		 * No further chunks are started once body returned something else than ok.
+		 * @return ok, or the first other status returned by body
+		 */
+		template<typename R, typename F>
+		R parallel_for_status(const char* phase, std::size_t n, R ok, F body, std::size_t chunk_size = 0);
+		/** Reduce the range [0, n) in parallel
+		 * Every chunk starts from identity and calls body(i, accumulator) for its indices,
+		 * the accumulators of all chunks are merged with combine(T, T) in no particular order.
+		 */
+		template<typename T, typename F, typename C>
+		T parallel_reduce(const char* phase, std::size_t n, T identity, F body, C combine, std::size_t chunk_size = 0);
+		/** Run body(item) for all items of the given queues and wait for completion
+		 * With steal, one task per queue works through its queue from the front, and a task whose queue ran empty
+		 * takes items from the back of the other queues, so queues should be ordered by decreasing cost.
+		 * Without steal, every worker runs exactly one task, which works through the queues q with q % threads equal
+		 * to its worker index, so the same queues are run by the same threads in every call.
+		 * The first exception thrown by body is rethrown after all workers stopped.
+		 */
+		template<typename F>
+		void parallel_for_queues(const char* phase, const std::vector<std::vector<std::size_t>>& queues, F body, bool steal = true);
+
+		/** Bind every worker thread to one CPU of the process affinity mask, worker i to the i-th allowed CPU (Linux only)
+		 * Keeps the data first touched by a worker on the memory node of its CPU. Must be called while the pool is idle.
+		 * @return if all workers could be bound
+		 */
+		bool pin_workers();
+		void join();
+		int get_thread_count() const;
+
+		/// Statistics of all tasks since the pool was created
+		std::vector<PhaseSummary> get_summary();
+		/// Statistics of the tasks since the previous call, must not be called while tasks are running
+		std::vector<PhaseSummary> take_interval_summary();
+		/// Fraction of the available worker time spent running tasks since the previous take_interval_summary()
+		double get_interval_utilization() const;
+		/// Write the statistics of the whole run to the log
+		void log_summary();
+
+	private:
+		struct PhaseStats {
+			Histogram wait;
+			Histogram run;
+			Histogram interval_wait;
+			Histogram interval_run;
+		};
+
+		/** Records the queue wait of a task on construction and its runtime on destruction, even if the task throws */
+		class TaskTimer {
+			public:
+				TaskTimer(TaskPool& pool, PhaseStats& stats, clock::time_point enqueued);
+				~TaskTimer();
+			private:
+				TaskPool& pool_;
+				PhaseStats& stats_;
+				clock::time_point start_;
+		};
+
+		static const std::size_t c_chunks_per_thread = 4;
+
+		/// Runs chunk_body(begin, end) for all chunks until it returns false or throws
+		template<typename F>
+		void run_chunked(const char* phase, std::size_t n, std::size_t chunk_size, F& chunk_body);
+		PhaseStats& get_phase_stats(const char* phase);
+		int get_worker_index();
+		static std::vector<PhaseSummary> summarize(const std::map<std::string, std::unique_ptr<PhaseStats>>& phases, bool interval);
+
+		int n_threads_;
+		boost::asio::thread_pool pool_;
+		std::mutex phases_mutex_;
+		std::map<std::string, std::unique_ptr<PhaseStats>> phases_;
+		std::atomic<int> n_workers_seen_;
+		std::vector<std::atomic<std::uint64_t>> busy_ns_;
+		std::vector<std::atomic<std::uint64_t>> interval_busy_ns_;
+		clock::time_point created_;
+		clock::time_point interval_start_;
+};
+
+template<typename F>
+auto TaskPool::submit(const char* phase, F task) -> std::future<decltype(task())> {
+	using result_t = decltype(task());
+	auto& stats = get_phase_stats(phase);
+	auto enqueued = clock::now();
+	auto packaged = std::make_shared<std::packaged_task<result_t()>> ([this, &stats, enqueued, task = std::move(task)]() mutable {
+		TaskTimer timer(*this, stats, enqueued);
+		return task();
+	});
+	auto future = packaged->get_future();
+	boost::asio::post(pool_, [packaged]() { (*packaged)(); });
+	return future;
+}
+
+template<typename F>
+void TaskPool::run_chunked(const char* phase, std::size_t n, std::size_t chunk_size, F& chunk_body) {
+	if (n == 0) return;
+	if (chunk_size == 0) chunk_size = std::max<std::size_t>(1, n / (n_threads_ * c_chunks_per_thread));
+	std::size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+	std::size_t n_tasks = std::min<std::size_t>(n_chunks, n_threads_);
+	auto& stats = get_phase_stats(phase);
+
+	std::atomic<std::size_t> next_chunk(0);
+	std::atomic<bool> stopped(false);
+	// only written by the chunk that stopped the loop first, read after the latch synchronized all workers
+	std::exception_ptr error;
+	Latch latch(n_tasks);
+	auto enqueued = clock::now();
+	for (std::size_t t = 0; t < n_tasks; t++) {
+		boost::asio::post(pool_, [&]() {
+			for (std::size_t chunk = next_chunk++; chunk < n_chunks && !stopped; chunk = next_chunk++) {
+				TaskTimer timer(*this, stats, enqueued);
+				try {
+					if (!chunk_body(chunk * chunk_size, std::min(n, (chunk + 1) * chunk_size))) stopped = true;
+				} catch (...) {
+					if (!stopped.exchange(true)) error = std::current_exception();
+				}
+			}
+			latch.count_down();
+		});
+	}
+	latch.wait();
+	if (error) std::rethrow_exception(error);
+}
+
+template<typename F>
+void TaskPool::parallel_for(const char* phase, std::size_t n, F body, std::size_t chunk_size) {
+	auto chunk_body = [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) body(i);
+		return true;
+	};
+	run_chunked(phase, n, chunk_size, chunk_body);
+}
+
+template<typename R, typename F>
+R TaskPool::parallel_for_status(const char* phase, std::size_t n, R ok, F body, std::size_t chunk_size) {
+	std::mutex status_mutex;
+	R status = ok;
+	auto chunk_body = [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			R result = body(i);
+			if (result == ok) continue;
+			const std::lock_guard<std::mutex> lock(status_mutex);
+			if (status == ok) status = result;
+			return false;
+		}
+		return true;
+	};
+	run_chunked(phase, n, chunk_size, chunk_body);
+	return status;
+}
+
+template<typename T, typename F, typename C>
+T TaskPool::parallel_reduce(const char* phase, std::size_t n, T identity, F body, C combine, std::size_t chunk_size) {
+	std::mutex result_mutex;
+	T result = identity;
+	auto chunk_body = [&](std::size_t begin, std::size_t end) {
+		T accumulator = identity;
+		for (std::size_t i = begin; i < end; i++) body(i, accumulator);
+		const std::lock_guard<std::mutex> lock(result_mutex);
+		result = combine(std::move(result), std::move(accumulator));
+		return true;
+	};
+	run_chunked(phase, n, chunk_size, chunk_body);
+	return result;
+}
+
+template<typename F>
+void TaskPool::parallel_for_queues(const char* phase, const std::vector<std::vector<std::size_t>>& queues, F body, bool steal) {
+	struct QueueState {
+		std::mutex mutex;
+		std::size_t front = 0;
+		std::size_t back = 0;
+		std::atomic<bool> claimed{false};
+	};
+	std::size_t n_queues = queues.size();
+	if (n_queues == 0) return;
+	std::vector<QueueState> states(n_queues);
+	for (std::size_t q = 0; q < n_queues; q++) states[q].back = queues[q].size();
+	auto& stats = get_phase_stats(phase);
+
+	std::atomic<bool> stopped(false);
+	std::exception_ptr error;
+	auto enqueued = clock::now();
+	// the owner of a queue takes items from its front, thieves from its back
+	auto take = [&](std::size_t q, bool owner, std::size_t& item) {
+		auto& state = states[q];
+		const std::lock_guard<std::mutex> lock(state.mutex);
+		if (state.front == state.back) return false;
+		item = owner ? queues[q][state.front++] : queues[q][--state.back];
+		return true;
+	};
+	auto run = [&](std::size_t item) {
+		TaskTimer timer(*this, stats, enqueued);
+		try {
+			body(item);
+		} catch (...) {
+			if (!stopped.exchange(true)) error = std::current_exception();
+		}
+	};
+	if (!steal) {
+		// every task waits for all others to start, so each one runs on a different worker, like in pin_workers
+		Latch started(n_threads_);
+		Latch done(n_threads_);
+		for (int t = 0; t < n_threads_; t++) {
+			boost::asio::post(pool_, [&]() {
+				started.count_down();
+				started.wait();
+				std::size_t item;
+				for (std::size_t q = get_worker_index(); q < n_queues; q += n_threads_)
+					while (!stopped && take(q, true, item)) run(item);
+				done.count_down();
+			});
+		}
+		done.wait();
+		if (error) std::rethrow_exception(error);
+		return;
+	}
+	Latch latch(n_queues);
+	for (std::size_t t = 0; t < n_queues; t++) {
+		boost::asio::post(pool_, [&]() {
+			// one task per queue, so there is always an unclaimed queue left
+			std::size_t own = get_worker_index() % n_queues;
+			if (states[own].claimed.exchange(true))
+				for (own = 0; states[own].claimed.exchange(true); own++);
+			std::size_t item;
+			while (!stopped && take(own, true, item)) run(item);
+			for (std::size_t offset = 1; offset < n_queues; offset++) {
+				std::size_t victim = (own + offset) % n_queues;
+				while (!stopped && take(victim, false, item)) run(item);
+			}
+			latch.count_down();
+		});
+	}
+	latch.wait();
+	if (error) std::rethrow_exception(error);
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TopKPaths.hpp"
+
+#include <assert.h>
+#include <utility>
+
+TopKPaths::TopKPaths(int k, int n_pending) :
+	k_(k),
+	pending_(n_pending),
+	confirmed_(0) {
+	assert(k_ > 0);
+	assert(pending_ >= 0);
+}
+
+std::vector<Path> TopKPaths::push(Path path) {
+	const std::lock_guard<std::mutex> lock(mutex_);
+	assert(pending_ > 0);
+	pending_--;
+	int slots = k_ - confirmed_;
+	if ((int) candidates_.size() < slots) {
+		candidates_.insert(std::move(path));
+	} else if (!candidates_.empty() && path < *candidates_.rbegin()) {
+		// the current worst candidate can not be among the k best anymore
+		candidates_.erase(std::prev(candidates_.end()));
+		candidates_.insert(std::move(path));
+	}
+	return confirm();
+}
+
+std::vector<Path> TopKPaths::skip() {
+	const std::lock_guard<std::mutex> lock(mutex_);
+	assert(pending_ > 0);
+	pending_--;
+	return confirm();
+}
+
+/** Hands out the best candidate as long as the pending networks can not displace it
+ * Needs to be called with the mutex held.
+ */
+std::vector<Path> TopKPaths::confirm() {
+	std::vector<Path> winners;
+	while (!candidates_.empty() && pending_ < k_ - confirmed_) {
+		auto best = candidates_.begin();
+		winners.push_back(std::move(candidates_.extract(best).value()));
+		confirmed_++;
+	}
+	return winners;
+}
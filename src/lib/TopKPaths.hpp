@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __TOPKPATHS_HPP
+#define __TOPKPATHS_HPP
+
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "Path.hpp"
+
+/** Thread safe, bounded selection of the k shortest paths of one pricing round
+ * Each network reports its shortest path (or the absence of a negative one) as soon as it is computed.
+ * A candidate is confirmed as a winner once it can no longer be pushed out of the k best by the networks still pending,
+ * i.e. its rank plus the number of pending networks is smaller than the number of free slots.
+ * Confirmed winners are handed back to the reporting worker, so column generation overlaps with the remaining shortest path tasks.
+ */
+class TopKPaths {
+	public:
+		TopKPaths(int k, int n_pending);
+
+		/// Reports a negative path of a network, returns all paths confirmed by this report
+		std::vector<Path> push(Path path);
+		/// Reports a network without a negative path, returns all paths confirmed by this report
+		std::vector<Path> skip();
+
+		int get_confirmed_count() const { return confirmed_; }
+
+	private:
+		std::vector<Path> confirm();
+
+		int k_;
+		int pending_;
+		int confirmed_;
+		std::mutex mutex_;
+		std::multiset<Path> candidates_;
+};
+
+#endif
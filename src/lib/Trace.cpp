@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.hpp"
+
+#include <fstream>
+#include <iomanip>
+
+#include "logging.hpp"
+
+Trace* g_trace = nullptr;
+
+Trace::Trace(const std::string& filename) :
+	filename_(filename),
+	origin_(clock::now()) {}
+
+Trace::ThreadBuffer& Trace::buffer() {
+	// a thread only ever records to a single trace, so the buffer can be cached per thread
+	thread_local Trace* s_owner = nullptr;
+	thread_local ThreadBuffer* s_buffer = nullptr;
+	if (s_owner != this) {
+		const std::lock_guard<std::mutex> lock(buffers_mutex_);
+		buffers_.push_back(std::make_unique<ThreadBuffer>(ThreadBuffer{static_cast<int>(buffers_.size()), {}}));
+		s_buffer = buffers_.back().get();
+		s_owner = this;
+	}
+	return *s_buffer;
+}
+
+void Trace::record(const char* name, const char* category, int id, clock::time_point start, clock::time_point end) {
+	auto& buf = buffer();
+	buf.events.push_back(Event{name, category, id, buf.thread, start, end});
+}
+
+void Trace::write() {
+	std::ofstream file(filename_);
+	if (!file) ABORT_F("Unable to open trace file %s", filename_.c_str());
+	LOG_F(1, "Writing trace to %s", filename_.c_str());
+
+	const std::lock_guard<std::mutex> lock(buffers_mutex_);
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto &buf : buffers_) {
+		for (const auto &event : buf->events) {
+			double ts = std::chrono::duration<double, std::micro>(event.start - origin_).count();
+			double dur = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+			file << (first ? "\n" : ",\n")
+				<< "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\""
+				<< ",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << ts << ",\"dur\":" << dur;
+			if (event.id >= 0) file << ",\"args\":{\"id\":" << event.id << "}";
+			file << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+}
@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __TRACE_HPP
+#define __TRACE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Records the activity of the thread pool as Chrome trace events
+ * Every thread appends to its own event buffer, so recording does not contend on a lock.
+ * The buffers are merged into a trace-event JSON file by write(), which can be opened in Perfetto or chrome://tracing.
+ * Recording is enabled by pointing g_trace to an instance, all recording helpers are a single branch otherwise.
+ */
+class Trace {
+	public:
+		using clock = std::chrono::steady_clock;
+
+		struct Event {
+			const char* name;
+			const char* category;
+			int id;
+			int thread;
+			clock::time_point start;
+			clock::time_point end;
+		};
+
+		Trace(const std::string& filename);
+
+		/// Records an event of the calling thread, id is the network (or constraint) the work belongs to, -1 if none
+		void record(const char* name, const char* category, int id, clock::time_point start, clock::time_point end);
+		/// Writes all events recorded so far to the trace file
+		void write();
+
+	private:
+		struct ThreadBuffer {
+			int thread;
+			std::vector<Event> events;
+		};
+
+		ThreadBuffer& buffer();
+
+		std::string filename_;
+		clock::time_point origin_;
+		std::mutex buffers_mutex_;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+/// The active trace, nullptr if tracing is disabled
+extern Trace* g_trace;
+
+/** Records the lifetime of the scope as a task event on the active trace */
+class TraceScope {
+	public:
+		TraceScope(const char* name, int id = -1) :
+			name_(name),
+			id_(id) {
+			if (g_trace) start_ = Trace::clock::now();
+		}
+
+		~TraceScope() {
+			if (g_trace) g_trace->record(name_, "task", id_, start_, Trace::clock::now());
+		}
+
+		void set_id(int id) { id_ = id; }
+
+	private:
+		const char* name_;
+		int id_;
+		Trace::clock::time_point start_;
+};
+
+/** Locks the mutex, recording the time spent waiting for it on the active trace */
+inline void trace_lock(std::mutex& mutex, const char* name) {
+	if (!g_trace) {
+		mutex.lock();
+		return;
+	}
+	auto start = Trace::clock::now();
+	mutex.lock();
+	g_trace->record(name, "lock", -1, start, Trace::clock::now());
+}
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "generate_instance.hpp"
+
+#include <assert.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "logging.hpp"
+
+#include "Node.hpp"
+
+/*
+ * All random decisions are pure functions of the seed and the object they concern,
+ * so networks and LP can be written independently (and in any order) without keeping the instance in memory.
+ */
+static std::uint64_t mix(std::uint64_t x) {
+	// splitmix64 finalizer
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+static double uniform(std::uint64_t seed, std::uint64_t a, std::uint64_t b = 0, std::uint64_t c = 0, std::uint64_t d = 0) {
+	std::uint64_t h = mix(mix(mix(mix(mix(seed) ^ a) ^ b) ^ c) ^ d);
+	return (double) (h >> 11) / (double) (1ULL << 53);
+}
+
+int network_state_count(const InstanceParameters& params, int group) {
+	assert(params.states_min > 0 && params.states_min <= params.states_max);
+	double log_min = std::log((double) params.states_min);
+	double log_max = std::log((double) params.states_max + 1);
+	int states = (int) std::exp(log_min + uniform(params.seed, 1, group) * (log_max - log_min));
+	return std::min(std::max(states, params.states_min), params.states_max);
+}
+
+/** The node of a state, the state index is spread over laufbahngruppe, laufbahn and dienstgrad */
+static Node state_node(int group, int slice, int state) {
+	return Node{1 + state % 3, 1 + (state / 3) % 4, state / 12, slice, 1, false, group};
+}
+
+static Node source_node(int group) { return Node{0, 0, -2, -1, 0, false, group}; }
+static Node sink_node(int group) { return Node{0, 0, 35, -1, 0, false, group}; }
+
+/// Constraint index of all arcs into (slice, state), or -1 if the arc of this network is not part of it
+static int arc_constraint(const InstanceParameters& params, int group, int slice, int state, int step) {
+	if (uniform(params.seed, 2, group, (std::uint64_t) slice * params.states_max + state, step) >= params.density) return -1;
+	return (int) (((std::uint64_t) slice * params.states_max + state) % params.constraints);
+}
+
+void write_network(const InstanceParameters& params, int group, const std::string& filename) {
+	std::ofstream file(filename);
+	if (!file) ABORT_F("Unable to open %s for writing", filename.c_str());
+	int n_states = network_state_count(params, group);
+
+	file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		<< "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+		<< "    <key id=\"key0\" for=\"node\" attr.name=\"laufbahngruppe\" attr.type=\"int\"/>\n"
+		<< "    <key id=\"key1\" for=\"node\" attr.name=\"laufbahn\" attr.type=\"int\"/>\n"
+		<< "    <key id=\"key2\" for=\"node\" attr.name=\"dienstgrad\" attr.type=\"int\"/>\n"
+		<< "    <key id=\"key3\" for=\"node\" attr.name=\"zeitscheibe\" attr.type=\"int\"/>\n"
+		<< "    <key id=\"key4\" for=\"node\" attr.name=\"status\" attr.type=\"int\"/>\n"
+		<< "    <key id=\"key5\" for=\"node\" attr.name=\"ausbildung\" attr.type=\"boolean\"/>\n"
+		<< "    <key id=\"key6\" for=\"node\" attr.name=\"netzwerk\" attr.type=\"int\"/>\n"
+		<< "    <graph edgedefault=\"directed\">\n";
+
+	auto write_node = [&](long id, const Node& node) {
+		file << "        <node id=\"" << id << "\">"
+			<< "<data key=\"key0\">" << node.laufbahngruppe << "</data>"
+			<< "<data key=\"key1\">" << node.laufbahn << "</data>"
+			<< "<data key=\"key2\">" << node.dienstgrad << "</data>"
+			<< "<data key=\"key3\">" << node.zeitscheibe << "</data>"
+			<< "<data key=\"key4\">" << node.status << "</data>"
+			<< "<data key=\"key5\">" << (node.ausbildung ? "true" : "false") << "</data>"
+			<< "<data key=\"key6\">" << node.netzwerk << "</data></node>\n";
+	};
+	auto write_edge = [&](long source, long target) {
+		file << "        <edge source=\"" << source << "\" target=\"" << target << "\"/>\n";
+	};
+	auto state_id = [&](int slice, int state) { return 3 + (long) slice * n_states + state; };
+
+	write_node(1, source_node(group));
+	write_node(2, sink_node(group));
+	for (int t = 0; t < params.slices; t++)
+		for (int s = 0; s < n_states; s++) write_node(state_id(t, s), state_node(group, t, s));
+
+	for (int s = 0; s < n_states; s++) write_edge(1, state_id(0, s));
+	for (int t = 0; t + 1 < params.slices; t++)
+		for (int s = 0; s < n_states; s++)
+			for (int j = 0; j < params.branching && s + j < n_states; j++) write_edge(state_id(t, s), state_id(t + 1, s + j));
+	for (int s = 0; s < n_states; s++) write_edge(state_id(params.slices - 1, s), 2);
+
+	file << "    </graph>\n</graphml>\n";
+}
+
+/** Format a node as LP index list, negative numbers are written as negX */
+static void write_lp_node(std::ofstream &file, const Node& node) {
+	auto negx = [&](int i) {
+		if (i < 0) file << "neg" << -i; else file << i;
+	};
+	file << node.laufbahngruppe << "|" << node.laufbahn << "|";
+	negx(node.dienstgrad);
+	file << "|";
+	negx(node.zeitscheibe);
+	file << "|" << node.status << "|" << (node.ausbildung ? "true" : "false") << "|" << node.netzwerk;
+}
+
+/** Write the master LP: maximize sum w_c b_c subject to b_c - sum of the y-variables of c = 0 and b_c <= cap_c
+ * Terms are written a few per line, SCIP's LP reader limits the line length.
+ */
+void write_lp(const InstanceParameters& params, const std::string& filename) {
+	std::ofstream file(filename);
+	if (!file) ABORT_F("Unable to open %s for writing", filename.c_str());
+	std::vector<int> n_states(params.networks + 1);
+	for (int g = 1; g <= params.networks; g++) n_states[g] = network_state_count(params, g);
+
+	file << "\\ synthetic instance: networks " << params.networks << ", slices " << params.slices
+		<< ", states " << params.states_min << "-" << params.states_max << ", seed " << params.seed << "\n";
+	file << "Maximize\nobj:";
+	for (int c = 0; c < params.constraints; c++) {
+		file << " + " << 1 + (int) (uniform(params.seed, 3, c) * 10) << " b" << c;
+		if (c % 8 == 7) file << "\n";
+	}
+	file << "\n\nSubject To\n";
+	for (int c = 0; c < params.constraints; c++) {
+		file << "beta" << c << ": b" << c;
+		int n_terms = 0;
+		// all (slice, state) targets mapping to this constraint, see arc_constraint()
+		for (std::uint64_t target = c; target < (std::uint64_t) params.slices * params.states_max; target += params.constraints) {
+			int slice = target / params.states_max;
+			int state = target % params.states_max;
+			if (slice == 0) continue;
+			for (int g = 1; g <= params.networks; g++) {
+				if (state >= n_states[g]) continue;
+				for (int j = 0; j < params.branching && state - j >= 0; j++) {
+					if (arc_constraint(params, g, slice, state, j) != c) continue;
+					file << " - y(";
+					write_lp_node(file, state_node(g, slice - 1, state - j));
+					file << ",";
+					write_lp_node(file, state_node(g, slice, state));
+					file << ")";
+					if (++n_terms % 4 == 0) file << "\n";
+				}
+			}
+		}
+		file << " = 0\n";
+	}
+	for (int c = 0; c < params.constraints; c++)
+		file << "alpha" << c << ": b" << c << " <= " << 1 + (int) (uniform(params.seed, 4, c) * 100) << "\n";
+	file << "\nBounds\n";
+	for (int c = 0; c < params.constraints; c++) file << "b" << c << " >= 0\n";
+	file << "\nEnd\n";
+}
+
+/** Write the LP to <directory>/instance.lp and the networks to <directory>/graphs/network_<group>.xml */
+void generate_instance(const InstanceParameters& params, const std::string& directory) {
+	LOG_SCOPE_F(1, "Generating synthetic instance in %s", directory.c_str());
+	std::filesystem::create_directories(std::filesystem::path(directory) / "graphs");
+	for (int g = 1; g <= params.networks; g++)
+		write_network(params, g, (std::filesystem::path(directory) / "graphs" / ("network_" + std::to_string(g) + ".xml")).string());
+	write_lp(params, (std::filesystem::path(directory) / "instance.lp").string());
+}
@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __GENERATE_INSTANCE_HPP
+#define __GENERATE_INSTANCE_HPP
+
+#include <cstdint>
+#include <string>
+
+/** Parameters of a synthetic GFCG instance
+ * Every network is time expanded: each of its states exists once per time slice (zeitscheibe),
+ * a state advances to itself or one of the next branching - 1 states in the following slice.
+ * The state count of each network is drawn log-uniformly from [states_min, states_max], so network sizes may vary by orders of magnitude.
+ * Arcs into the same (slice, state) pair of all networks share a constraint, each arc is part of it with probability density.
+ */
+struct InstanceParameters {
+	int networks = 10;
+	int slices = 20;
+	int states_min = 10;
+	int states_max = 50;
+	int branching = 2;
+	int constraints = 100;
+	double density = 0.5;
+	std::uint64_t seed = 1;
+};
+
+int network_state_count(const InstanceParameters& params, int group);
+void write_network(const InstanceParameters& params, int group, const std::string& filename);
+void write_lp(const InstanceParameters& params, const std::string& filename);
+void generate_instance(const InstanceParameters& params, const std::string& directory);
+
+#endif
@@ -23,44 +23,44 @@
 #include "initialize.hpp"
 
 #include <assert.h>
+#include <algorithm>
 #include <filesystem>
 #include <functional>
-#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <vector>
 
-#include <boost/asio.hpp>
 #include <boost/optional.hpp>
-#include "loguru.hpp"
+#include "logging.hpp"
 #include <objscip/objscipdefplugins.h>
 
 #include "Arc.hpp"
 #include "Network.hpp"
 #include "parse_lp.hpp"
+#include "PerfCounters.hpp"
+#include "Trace.hpp"
+#include "memory_usage.hpp"
 
-void generate_networks(SCIP * scip, DataManager& data_manager, boost::asio::thread_pool& tpool, std::string graphs_location) {
+void generate_networks(SCIP * scip, DataManager& data_manager, TaskPool& tpool, std::string graphs_location) {
 	LOG_SCOPE_F(1, "Starting to parse graph XML files (generate_networks())");
-	std::vector<std::future<void>> network_read_futures;
-	bool network_found = false;
-	for (const auto &entry : std::filesystem::directory_iterator(graphs_location)) {
-		if (entry.path().extension().compare(".xml") == 0) {
-			auto task = std::make_shared<std::packaged_task<void()>> (std::bind([&](std::string path) {
-				LOG_F(2, "Parsing graph: \'%s\'", path.c_str());
-				std::vector<Arc> arc_list;
-				Network net(path, arc_list);
-				int net_group = net.get_group();
-				data_manager.add_network(net_group, std::move(net));
-				data_manager.add_arcs_of_network(net_group, arc_list);
-			}, std::move(entry.path())));
-			network_read_futures.push_back(std::move(task->get_future()));
-			boost::asio::post(tpool, std::bind(&std::packaged_task<void()>::operator(), task));
-			network_found = true;
-		}
-	}
-	for (auto& future : network_read_futures) future.wait();
-	if (!network_found) ABORT_F("Did not find any XML files at %s", graphs_location.c_str());
+	std::vector<std::string> paths;
+	for (const auto &entry : std::filesystem::directory_iterator(graphs_location))
+		if (entry.path().extension().compare(".xml") == 0) paths.push_back(entry.path());
+	if (paths.empty()) ABORT_F("Did not find any XML files at %s", graphs_location.c_str());
+
+	// one network per chunk, parsing times vary a lot between networks
+	tpool.parallel_for("read_network", paths.size(), [&](std::size_t i) {
+		TraceScope trace("read_network");
+		LOG_F(2, "Parsing graph: \'%s\'", paths[i].c_str());
+		std::vector<Arc> arc_list;
+		Network net(paths[i], arc_list);
+		int net_group = net.get_group();
+		trace.set_id(net_group);
+		data_manager.add_network(net_group, std::move(net));
+		data_manager.add_arcs_of_network(net_group, arc_list);
+	}, 1);
 }
 
 void generate_maps(SCIP * scip, DataManager& data_manager, std::vector<std::string> unneeded_constraints_substrings) {
@@ -133,9 +133,115 @@ void generate_maps(SCIP * scip, DataManager& data_manager, std::vector<std::stri
 	}
 }
 
-void initialize_container(SCIP * scip, DataManager& data_manager, boost::asio::thread_pool& tpool,
+void initialize_container(SCIP * scip, DataManager& data_manager, TaskPool& tpool,
 		std::string graphs_location, std::vector<std::string> unneeded_constraints_substrings) {
 	assert(scip != NULL);
-	generate_networks(scip, data_manager, tpool, graphs_location);
+	CounterValues load_counters = {0, 0, 0, 0};
+	{
+		CounterScope counters(load_counters);
+		generate_networks(scip, data_manager, tpool, graphs_location);
+	}
+	if (g_perf_counters) log_counters("loading networks", load_counters);
+	log_memory_usage(data_manager, "loading networks");
 	generate_maps(scip, data_manager, unneeded_constraints_substrings);
+	log_memory_usage(data_manager, "generating maps");
+}
+
+/** Shrink every network by Network::reduce, treating the arcs of pricing constraints as weighted
+ * Has to be called after initialize_container(), and before columns are imported or seeded for the covering paths to be reduced too.
+ */
+void reduce_networks(DataManager& data_manager, TaskPool& tpool) {
+	LOG_SCOPE_F(1, "Reducing networks (reduce_networks())");
+	const auto& networks = data_manager.get_network_list();
+	auto is_weighted = [&](const Arc& arc) { return (bool) data_manager.get_constraints_of_arc(arc); };
+	auto total = tpool.parallel_reduce("reduce", networks.size(), Network::ReductionStats{0, 0, 0, 0},
+		[&](std::size_t i, Network::ReductionStats& sum) {
+			auto stats = networks[i]->reduce(is_weighted);
+			sum.vertices_before += stats.vertices_before;
+			sum.edges_before += stats.edges_before;
+			sum.vertices_after += stats.vertices_after;
+			sum.edges_after += stats.edges_after;
+		},
+		[](Network::ReductionStats a, const Network::ReductionStats& b) {
+			return Network::ReductionStats{a.vertices_before + b.vertices_before, a.edges_before + b.edges_before,
+				a.vertices_after + b.vertices_after, a.edges_after + b.edges_after};
+		});
+	LOG_F(INFO, "Reduced networks from %zu to %zu vertices and from %zu to %zu edges",
+			total.vertices_before, total.vertices_after, total.edges_before, total.edges_after);
+	log_memory_usage(data_manager, "reducing networks");
+}
+
+/** Add a path as a variable to the original problem, before solving starts
+ * In contrast to the priced variables of ObjPricerGFCG this works on the original constraints, so it has to be called
+ * after initialize_container() and before SCIPsolve(). The variable is registered with the data manager under its original name.
+ */
+SCIP_RETCODE add_initial_column(SCIP * scip, DataManager& data_manager, const std::string& varname, Path path, bool integer_paths) {
+	SCIP_VAR * var = NULL;
+	SCIP_CALL( SCIPcreateVarBasic(
+				scip, &var, varname.c_str(),
+				0, // lower bound
+				SCIPinfinity(scip), // upper bound
+				0, // objective
+				integer_paths ? SCIP_VARTYPE_INTEGER : SCIP_VARTYPE_CONTINUOUS) );
+	SCIP_CALL( SCIPaddVar(scip, var) );
+	for (const auto &arc : path.arcs) {
+		auto constraints_optional = data_manager.get_constraints_of_arc(arc);
+		if (!constraints_optional) continue;
+		for (const auto &cons_info : *constraints_optional) {
+			SCIP_CALL( SCIPaddCoefLinear(scip, cons_info.first, var, cons_info.second) );
+		}
+	}
+	data_manager.add_var_path_pair(varname, std::move(path));
+	SCIP_CALL( SCIPreleaseVar(scip, &var) );
+	return SCIP_OKAY;
+}
+
+/** Generate initial path variables, such that the master problem is feasible (or close to it) before the first pricing round
+ * seed_strategy 1: add the shortest path of each network under zero edge weights <br>
+ * seed_strategy 2: add paths per network such that every arc appearing in a pricing constraint is covered by a path <br>
+ * @param max_paths_per_network bound on the number of seed paths per network for strategy 2, zero means no bound
+ * @return the number of added variables
+ */
+int seed_columns(SCIP * scip, DataManager& data_manager, TaskPool& tpool, int seed_strategy, int max_paths_per_network, bool integer_paths) {
+	assert(scip != NULL);
+	if (seed_strategy <= 0) return 0;
+	LOG_SCOPE_F(1, "Generating seed columns (seed_columns()), strategy %d", seed_strategy);
+
+	// group the arcs of all pricing constraints by network, sorted for reproducible seeds
+	std::map<int, std::vector<Arc>> constraint_arcs_of_network;
+	if (seed_strategy >= 2) {
+		for (const auto &pair : data_manager.get_arc_to_scip_constraints_map())
+			constraint_arcs_of_network[data_manager.get_network(pair.first).get_group()].push_back(pair.first);
+		for (auto &pair : constraint_arcs_of_network) std::sort(pair.second.begin(), pair.second.end());
+	}
+
+	const auto& networks = data_manager.get_network_list();
+	std::map<int, std::vector<Path>> seed_paths;
+	for (auto net : networks) seed_paths[net->get_group()];
+
+	tpool.parallel_for("seed", networks.size(), [&](std::size_t i) {
+		auto& net = *networks[i];
+		TraceScope trace("seed", net.get_group());
+		auto& paths = seed_paths.at(net.get_group());
+		if (seed_strategy == 1) {
+			net.reset_edge_weights();
+			paths.push_back(net.shortest_path());
+			return;
+		}
+		auto res = constraint_arcs_of_network.find(net.get_group());
+		if (res == constraint_arcs_of_network.end()) return;
+		paths = net.covering_paths(res->second, max_paths_per_network);
+	});
+
+	int n_seeds = 0;
+	for (auto &pair : seed_paths) {
+		for (auto &path : pair.second) {
+			std::string varname = "s_" + std::to_string(n_seeds);
+			if (add_initial_column(scip, data_manager, varname, std::move(path), integer_paths) != SCIP_OKAY)
+				ABORT_F("Failed to add seed column %s", varname.c_str());
+			n_seeds++;
+		}
+	}
+	LOG_F(1, "Added %d seed columns", n_seeds);
+	return n_seeds;
 }
@@ -26,11 +26,15 @@
 #include <string>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <objscip/objscip.h>
 
 #include "DataManager.hpp"
+#include "Path.hpp"
+#include "TaskPool.hpp"
 
-void initialize_container(SCIP * scip, DataManager& data_manager, boost::asio::thread_pool& tpool, std::string graphs_location, std::vector<std::string> unneeded_constraints_substrings);
+void initialize_container(SCIP * scip, DataManager& data_manager, TaskPool& tpool, std::string graphs_location, std::vector<std::string> unneeded_constraints_substrings);
+void reduce_networks(DataManager& data_manager, TaskPool& tpool);
+SCIP_RETCODE add_initial_column(SCIP * scip, DataManager& data_manager, const std::string& varname, Path path, bool integer_paths);
+int seed_columns(SCIP * scip, DataManager& data_manager, TaskPool& tpool, int seed_strategy, int max_paths_per_network, bool integer_paths);
 
 #endif
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __LOGGING_HPP
+#define __LOGGING_HPP
+
+#include "loguru.hpp"
+
+/** Compile-time verbosity ceiling for all loguru logging macros
+ * Statements with a verbosity above HALLIGALLI_MAX_LOG_VERBOSITY (set with the CMake option of the same name)
+ * are discarded by the compiler together with the evaluation of their arguments, no matter the runtime verbosity.
+ * The macros are redefined on top of loguru, so LOG_F, DLOG_F and LOG_SCOPE_F pick up the ceiling in every
+ * translation unit that includes this header instead of loguru.hpp.
+ */
+#ifndef HALLIGALLI_MAX_LOG_VERBOSITY
+	#define HALLIGALLI_MAX_LOG_VERBOSITY 9
+#endif
+
+#undef VLOG_F
+#define VLOG_F(verbosity, ...)                                                                     \
+	((verbosity) > HALLIGALLI_MAX_LOG_VERBOSITY || (verbosity) > loguru::current_verbosity_cutoff()) \
+		? (void)0                                                                                  \
+		: loguru::log(verbosity, __FILE__, __LINE__, __VA_ARGS__)
+
+#undef VLOG_IF_F
+#define VLOG_IF_F(verbosity, cond, ...)                                                            \
+	((verbosity) > HALLIGALLI_MAX_LOG_VERBOSITY || (verbosity) > loguru::current_verbosity_cutoff() \
+			|| (cond) == false)                                                                    \
+		? (void)0                                                                                  \
+		: loguru::log(verbosity, __FILE__, __LINE__, __VA_ARGS__)
+
+#undef VLOG_SCOPE_F
+#define VLOG_SCOPE_F(verbosity, ...)                                                               \
+	loguru::LogScopeRAII LOGURU_ANONYMOUS_VARIABLE(error_context_RAII_) =                          \
+	((verbosity) > HALLIGALLI_MAX_LOG_VERBOSITY || (verbosity) > loguru::current_verbosity_cutoff()) \
+		? loguru::LogScopeRAII()                                                                   \
+		: loguru::LogScopeRAII(verbosity, __FILE__, __LINE__, __VA_ARGS__)
+
+#endif
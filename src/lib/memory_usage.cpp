@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memory_usage.hpp"
+
+#include <cstdio>
+#include <unistd.h>
+
+#include "DataManager.hpp"
+#include "logging.hpp"
+
+/** Reads the resident page count from /proc/self/statm, which is a single small read without parsing the full status */
+std::size_t get_rss_bytes() {
+	std::FILE* statm = std::fopen("/proc/self/statm", "r");
+	if (statm == NULL) return 0;
+	unsigned long size_pages = 0, resident_pages = 0;
+	int n_read = std::fscanf(statm, "%lu %lu", &size_pages, &resident_pages);
+	std::fclose(statm);
+	if (n_read != 2) return 0;
+	return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void log_memory_usage(DataManager& data_manager, const std::string& phase) {
+	const double c_mib = 1024.0 * 1024.0;
+	auto usage = data_manager.get_memory_usage();
+	std::size_t total = 0;
+	for (const auto &table : usage) total += table.second;
+	LOG_F(INFO, "Memory after %s: process RSS %.1f MiB, data manager estimate %.1f MiB",
+			phase.c_str(), get_rss_bytes() / c_mib, total / c_mib);
+	for (const auto &table : usage) LOG_F(1, "%-24s %10.1f MiB", table.first.c_str(), table.second / c_mib);
+}
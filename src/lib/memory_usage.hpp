@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef __MEMORY_USAGE_HPP
+#define __MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Estimates of the heap memory held by standard containers
+ * These only depend on sizes and capacities, so they are cheap enough to be evaluated while solving.
+ * Node based containers are charged one allocation per element (value and two pointers) plus their bucket array,
+ * allocator overhead and memory owned by the elements themselves is not included.
+ */
+template<typename T>
+std::size_t vector_bytes(const std::vector<T>& vec) {
+	return vec.capacity() * sizeof(T);
+}
+
+template<typename M>
+std::size_t unordered_map_bytes(const M& map) {
+	return map.bucket_count() * sizeof(void*) + map.size() * (sizeof(typename M::value_type) + 2 * sizeof(void*));
+}
+
+template<typename M>
+std::size_t map_bytes(const M& map) {
+	// red-black tree nodes hold three pointers and the color
+	return map.size() * (sizeof(typename M::value_type) + 4 * sizeof(void*));
+}
+
+/// Named byte counts of the tables of one subsystem
+typedef std::vector<std::pair<std::string, std::size_t>> memory_usage_t;
+
+/// Resident set size of the process in bytes, 0 if it can not be determined
+std::size_t get_rss_bytes();
+
+class DataManager;
+/// Logs the process RSS and the estimated size of every data manager table, labeled with the current phase of the solver
+void log_memory_usage(DataManager& data_manager, const std::string& phase);
+
+#endif
@@ -24,7 +24,7 @@
 
 #include <vector>
 
-#include "loguru.hpp"
+#include "logging.hpp"
 
 #include "Node.hpp"
 
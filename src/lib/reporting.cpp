@@ -33,6 +33,22 @@ void write_path(std::ofstream &file, const Path& path, SCIP_Real val) {
 	}
 }
 
+/** Find the path a (transformed) variable was generated from
+ * Priced variables are registered under their own name. Variables added before solving (seed or warm start columns)
+ * are registered under the name of their original variable.
+ * @return the path, or none if the variable is not a path variable
+ */
+const boost::optional<const Path&> get_path_of_var(SCIP_VAR * var, const DataManager& data_manager) {
+	auto path_option = data_manager.get_path(SCIPvarGetName(var));
+	if (path_option) return path_option;
+	SCIP_VAR * orig_var = var;
+	SCIP_Real scalar = 1.0;
+	SCIP_Real constant = 0.0;
+	SCIP_CALL_ABORT( SCIPvarGetOrigvarSum(&orig_var, &scalar, &constant) );
+	if (orig_var == NULL) return boost::optional<const Path&>{};
+	return data_manager.get_path(SCIPvarGetName(orig_var));
+}
+
 void report_results_csv(SCIP * scip, DataManager& data_manager) {
 	assert(scip != NULL);
 
@@ -64,9 +80,8 @@ void report_results_csv(SCIP * scip, DataManager& data_manager) {
 	SCIP_CALL_ABORT( SCIPgetSolVals(scip, best_sol, nvars, vars, vals.data()) );
 
 	for (int i = 0; i < nvars; i++) {
-		std::string varname = SCIPvarGetName(vars[i]);
-		// skip all variables other than p_n
-		auto path_option = data_manager.get_path(varname);
+		// skip all variables other than path variables
+		auto path_option = get_path_of_var(vars[i], data_manager);
 		if (!path_option) continue;
 		const auto& path = *path_option;
 		write_path(file, path, vals[i]);
@@ -23,10 +23,12 @@
 #ifndef __REPORTING_HPP
 #define __REPORTING_HPP
 
+#include <boost/optional.hpp>
 #include <objscip/objscip.h>
 
 #include "ObjPricerGFCG.hpp"
 
+const boost::optional<const Path&> get_path_of_var(SCIP_VAR * var, const DataManager& data_manager);
 void report_results_csv(SCIP * scip, DataManager& data_manager);
 
 #endif
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "warm_start.hpp"
+
+#include <assert.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "logging.hpp"
+
+#include "Arc.hpp"
+#include "Node.hpp"
+#include "Path.hpp"
+#include "initialize.hpp"
+#include "reporting.hpp"
+
+/*
+ * Column file format: a header line, followed by one line per path:
+ * <network group> <arc count> and 14 integers per arc (source and target node, in the order of the Node struct).
+ * Arcs are written in the order of Path::arcs, i.e. from the sink to the source.
+ */
+static const std::string c_columns_header = "halligalli-columns 1";
+
+namespace {
+	void write_node(std::ofstream &file, const Node& node) {
+		file << ' ' << node.laufbahngruppe
+			<< ' ' << node.laufbahn
+			<< ' ' << node.dienstgrad
+			<< ' ' << node.zeitscheibe
+			<< ' ' << node.status
+			<< ' ' << node.ausbildung
+			<< ' ' << node.netzwerk;
+	}
+
+	bool read_node(std::ifstream &file, Node& node) {
+		return static_cast<bool>(file >> node.laufbahngruppe
+			>> node.laufbahn
+			>> node.dienstgrad
+			>> node.zeitscheibe
+			>> node.status
+			>> node.ausbildung
+			>> node.netzwerk);
+	}
+}
+
+/** Write all path variables of the final problem to a column file, to be used as warm start by a later run */
+void export_columns(SCIP * scip, const DataManager& data_manager, const std::string& filename) {
+	assert(scip != NULL);
+	std::ofstream file(filename);
+	if (!file) ABORT_F("Unable to open column export file %s", filename.c_str());
+
+	file << c_columns_header << "\n";
+	int n_exported = 0;
+	int nvars = SCIPgetNVars(scip);
+	SCIP_VAR ** vars = SCIPgetVars(scip);
+	for (int i = 0; i < nvars; i++) {
+		auto path_option = get_path_of_var(vars[i], data_manager);
+		if (!path_option) continue;
+		const auto& path = *path_option;
+		file << path.network_group << ' ' << path.arcs.size();
+		for (const auto& arc : path.arcs) {
+			write_node(file, arc.source);
+			write_node(file, arc.target);
+		}
+		file << "\n";
+		n_exported++;
+	}
+	LOG_F(INFO, "Exported %d path columns to %s", n_exported, filename.c_str());
+}
+
+/** Add the paths of a column file as initial variables
+ * Paths of networks that do not exist anymore, or whose arcs are no source-sink path of their network anymore, are skipped.
+ * Has to be called after initialize_container() and before SCIPsolve().
+ * @return the number of imported columns
+ */
+int import_columns(SCIP * scip, DataManager& data_manager, const std::string& filename, bool integer_paths) {
+	assert(scip != NULL);
+	LOG_SCOPE_F(1, "Importing warm start columns from %s", filename.c_str());
+	std::ifstream file(filename);
+	if (!file) ABORT_F("Unable to open column import file %s", filename.c_str());
+
+	std::string header;
+	std::getline(file, header);
+	if (header != c_columns_header) ABORT_F("Column file %s has an unknown format", filename.c_str());
+
+	auto& networks = data_manager.get_networks();
+	int n_imported = 0;
+	int n_skipped = 0;
+	Path path;
+	std::size_t n_arcs;
+	while (file >> path.network_group >> n_arcs) {
+		path.length = 0;
+		path.arcs.resize(n_arcs);
+		for (auto& arc : path.arcs) {
+			if (!read_node(file, arc.source) || !read_node(file, arc.target))
+				ABORT_F("Column file %s is truncated or malformed", filename.c_str());
+		}
+
+		auto res = networks.find(path.network_group);
+		if (res == networks.end() || !res->second.is_path(path.arcs)) {
+			DLOG_F(3, "Skipping column of network %i, it is no path of the loaded networks", path.network_group);
+			n_skipped++;
+			continue;
+		}
+		std::string varname = "w_" + std::to_string(n_imported);
+		if (add_initial_column(scip, data_manager, varname, path, integer_paths) != SCIP_OKAY)
+			ABORT_F("Failed to add warm start column %s", varname.c_str());
+		n_imported++;
+	}
+	if (!file.eof()) ABORT_F("Column file %s is malformed", filename.c_str());
+	LOG_F(INFO, "Imported %d warm start columns, skipped %d outdated columns", n_imported, n_skipped);
+	return n_imported;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file
+ * @author Jurek Olden (jurek.olden@in.tum.de)
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2021 Jurek Olden
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __WARM_START_HPP
+#define __WARM_START_HPP
+
+#include <string>
+
+#include <objscip/objscip.h>
+
+#include "DataManager.hpp"
+
+void export_columns(SCIP * scip, const DataManager& data_manager, const std::string& filename);
+int import_columns(SCIP * scip, DataManager& data_manager, const std::string& filename, bool integer_paths);
+
+#endif
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "Arc.hpp"
+#include "Network.hpp"
+#include "ObjBranchruleArcFlow.hpp"
+#include "Path.hpp"
+#include "generate_instance.hpp"
+
+namespace {
+	Node node(int dienstgrad, int zeitscheibe, int netzwerk = 1) {
+		return Node{1, 1, dienstgrad, zeitscheibe, 1, false, netzwerk};
+	}
+
+	/// Adds the flow of the given paths over every arc
+	std::unordered_map<Arc, double> flow_of(const std::vector<std::pair<std::vector<Arc>, double>>& paths) {
+		std::unordered_map<Arc, double> arc_flow;
+		for (const auto& pair : paths)
+			for (const auto& arc : pair.first) arc_flow[arc] += pair.second;
+		return arc_flow;
+	}
+}
+
+TEST_CASE("Check decomposition of integral arc flows", "[arc_flow_branching]") {
+	// two diamonds in series: every arc carries flow one, but the four paths through them carry one half each
+	Node s = node(0, 0), a = node(1, 1), b = node(2, 1), x = node(0, 2), c = node(1, 3), d = node(2, 3), t = node(0, 4);
+	Arc sa{s, a}, sb{s, b}, ax{a, x}, bx{b, x}, xc{x, c}, xd{x, d}, ct{c, t}, dt{d, t};
+	// a second network with flow two over a single path
+	Node s2 = node(0, 0, 2), t2 = node(0, 1, 2);
+	Arc st2{s2, t2};
+	auto arc_flow = flow_of({
+		{{sa, ax, xc, ct}, 0.5},
+		{{sb, bx, xd, dt}, 0.5},
+		{{sa, ax, xd, dt}, 0.5},
+		{{sb, bx, xc, ct}, 0.5},
+		{{st2}, 2.0}
+	});
+	for (const auto& pair : arc_flow) REQUIRE(pair.second == Approx(std::round(pair.second)));
+
+	auto paths = decompose_arc_flow(arc_flow);
+	REQUIRE(paths.size() == 3);
+	std::unordered_map<Arc, double> decomposed_flow;
+	for (const auto& pair : paths) {
+		const auto& path = pair.first;
+		REQUIRE(pair.second > 0);
+		REQUIRE(path.network_group == -1);
+		REQUIRE(!path.arcs.empty());
+		// from the sink to the source, like the paths of the networks
+		REQUIRE((path.arcs.front().target == t || path.arcs.front().target == t2));
+		REQUIRE((path.arcs.back().source == s || path.arcs.back().source == s2));
+		for (std::size_t i = 1; i < path.arcs.size(); i++) REQUIRE(path.arcs[i - 1].source == path.arcs[i].target);
+		for (const auto& arc : path.arcs) decomposed_flow[arc] += pair.second;
+	}
+	REQUIRE(decomposed_flow == arc_flow);
+	REQUIRE(std::count_if(paths.begin(), paths.end(), [&](const auto& pair) { return pair.second == 2 && pair.first.arcs.front() == st2; }) == 1);
+
+	SECTION("The decomposition is deterministic and rounds to integers") {
+		auto rounded = arc_flow;
+		rounded[sa] += 1e-9;
+		rounded[dt] -= 1e-9;
+		auto again = decompose_arc_flow(rounded);
+		REQUIRE(again.size() == paths.size());
+		for (std::size_t p = 0; p < paths.size(); p++) {
+			REQUIRE(again[p].second == paths[p].second);
+			REQUIRE(again[p].first.arcs == paths[p].first.arcs);
+		}
+	}
+	SECTION("Arcs without flow are ignored") {
+		arc_flow[Arc{node(3, 1), node(3, 2)}] = 0;
+		REQUIRE(decompose_arc_flow(arc_flow).size() == 3);
+	}
+}
+
+TEST_CASE("Check decomposition of the flow of existing columns", "[arc_flow_branching]") {
+	InstanceParameters params;
+	params.slices = 6;
+	params.states_min = 8;
+	params.states_max = 8;
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_arc_flow_1").string();
+	write_network(params, 1, filename);
+	std::vector<Arc> arcs;
+	Network net(filename, arcs);
+	std::filesystem::remove(filename);
+
+	std::set<std::vector<Arc>> distinct;
+	for (const auto& path : net.covering_paths(arcs, 8)) distinct.insert(path.arcs);
+	std::vector<std::vector<Arc>> columns(distinct.begin(), distinct.end());
+	REQUIRE(columns.size() >= 3);
+	std::vector<std::pair<std::vector<Arc>, double>> column_flows;
+	for (std::size_t c = 0; c < columns.size(); c++) column_flows.emplace_back(columns[c], 1.0 + c % 2);
+	auto arc_flow = flow_of(column_flows);
+
+	SECTION("Decomposed paths are paths of the network") {
+		auto paths = decompose_arc_flow(arc_flow);
+		REQUIRE(!paths.empty());
+		for (const auto& pair : paths) REQUIRE(net.is_path(pair.first.arcs));
+	}
+	SECTION("The existing columns are reused") {
+		// the branching rule finds the variables of the columns by their arcs
+		auto paths = decompose_arc_flow(arc_flow, columns);
+		REQUIRE(paths.size() == columns.size());
+		for (std::size_t c = 0; c < columns.size(); c++) {
+			REQUIRE(paths[c].first.arcs == columns[c]);
+			REQUIRE(paths[c].second == column_flows[c].second);
+		}
+	}
+	SECTION("Columns without enough flow are skipped") {
+		auto missing = columns[0];
+		missing.front() = Arc{missing.front().source, Node{9, 9, 9, 9, 9, false, 1}};
+		auto paths = decompose_arc_flow(arc_flow, {missing, columns[1], columns[1]});
+		REQUIRE(paths[0].first.arcs == columns[1]);
+		REQUIRE(std::count_if(paths.begin(), paths.end(), [&](const auto& pair) { return pair.first.arcs == columns[1]; }) == 1);
+		std::unordered_map<Arc, double> decomposed_flow;
+		for (const auto& pair : paths) {
+			REQUIRE(net.is_path(pair.first.arcs));
+			for (const auto& arc : pair.first.arcs) decomposed_flow[arc] += pair.second;
+		}
+		REQUIRE(decomposed_flow == arc_flow);
+	}
+}
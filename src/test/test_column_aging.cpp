@@ -0,0 +1,108 @@
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <objscip/objscip.h>
+#include <objscip/objscipdefplugins.h>
+
+#include "DataManager.hpp"
+#include "ObjPricerGFCG.hpp"
+#include "Path.hpp"
+#include "TaskPool.hpp"
+
+namespace {
+	/// Exposes the column aging of the pricer, which is otherwise only driven by the reduced cost pricing of a solve
+	class AgingPricer : public ObjPricerGFCG {
+		public:
+			AgingPricer(SCIP * scip, DataManager& data_manager, TaskPool& tpool) :
+				ObjPricerGFCG(scip, "aging_pricer", data_manager, tpool) {}
+
+			/// Tracks a variable like generate_columns does, the pricer keeps its own capture
+			SCIP_RETCODE track(SCIP * scip, SCIP_VAR * var) {
+				SCIP_CALL( SCIPcaptureVar(scip, var) );
+				columns_.push_back(Column{var, 0});
+				return SCIP_OKAY;
+			}
+			/// One reduced cost iteration with the given solution
+			SCIP_RETCODE iterate(SCIP * scip, SCIP_SOL * sol) {
+				SCIP_CALL( update_column_ages(scip, sol) );
+				n_iterations_++;
+				return SCIP_OKAY;
+			}
+			std::size_t get_column_count() const { return columns_.size(); }
+			SCIP_RETCODE release(SCIP * scip) { return scip_exitsol(scip, NULL); }
+
+		private:
+			int select_columns(SCIP *, const std::function<SCIP_RETCODE(Path)>&) override { return 0; }
+	};
+
+	SCIP_VAR * add_path_variable(SCIP * scip, DataManager& data_manager, const std::string& name) {
+		SCIP_VAR * var = NULL;
+		SCIP_CALL_ABORT( SCIPcreateVarBasic(scip, &var, name.c_str(), 0, SCIPinfinity(scip), 0, SCIP_VARTYPE_CONTINUOUS) );
+		SCIPvarMarkDeletable(var);
+		SCIP_CALL_ABORT( SCIPaddVar(scip, var) );
+		data_manager.add_var_path_pair(name, Path());
+		return var;
+	}
+}
+
+TEST_CASE("Check column aging", "[column_aging]") {
+	TaskPool tpool(1);
+	DataManager data_manager;
+	SCIP * scip = NULL;
+	SCIP_CALL_ABORT( SCIPcreate(&scip) );
+	SCIP_CALL_ABORT( SCIPincludeDefaultPlugins(scip) );
+	SCIP_CALL_ABORT( SCIPsetIntParam(scip, "display/verblevel", 0) );
+	SCIP_CALL_ABORT( SCIPcreateProbBasic(scip, "column_aging") );
+
+	AgingPricer pricer(scip, data_manager, tpool);
+	SCIP_VAR * used = add_path_variable(scip, data_manager, "p_used");
+	SCIP_VAR * unused = add_path_variable(scip, data_manager, "p_unused");
+	SCIP_CALL_ABORT( pricer.track(scip, used) );
+	SCIP_CALL_ABORT( pricer.track(scip, unused) );
+	SCIP_SOL * sol = NULL;
+	SCIP_CALL_ABORT( SCIPcreateOrigSol(scip, &sol, NULL) );
+	SCIP_CALL_ABORT( SCIPsetSolVal(scip, sol, used, 1.0) );
+
+	SECTION("Columns at zero for more than the maximal age are deleted at the next cleanup") {
+		pricer.set_column_aging(2, 3);
+		// cleanups in the iterations 0 and 3, at the ages 1 and 4 of the unused column
+		for (int iteration = 0; iteration < 3; iteration++) {
+			SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+			REQUIRE(pricer.get_column_count() == 2);
+		}
+		SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+		REQUIRE(pricer.get_column_count() == 1);
+		REQUIRE(!data_manager.get_path("p_unused").is_initialized());
+		REQUIRE(data_manager.get_path("p_used").is_initialized());
+
+		// the used column stays as long as it has a positive value
+		for (int iteration = 0; iteration < 6; iteration++) SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+		REQUIRE(pricer.get_column_count() == 1);
+		REQUIRE(data_manager.get_path("p_used").is_initialized());
+	}
+	SECTION("A column is kept if it became positive again") {
+		pricer.set_column_aging(2, 1);
+		SCIP_CALL_ABORT( SCIPsetSolVal(scip, sol, used, 0.0) );
+		for (int iteration = 0; iteration < 2; iteration++) SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+		SCIP_CALL_ABORT( SCIPsetSolVal(scip, sol, used, 0.5) );
+		SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+		SCIP_CALL_ABORT( SCIPsetSolVal(scip, sol, used, 0.0) );
+		for (int iteration = 0; iteration < 2; iteration++) SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+		REQUIRE(pricer.get_column_count() == 1);
+		REQUIRE(data_manager.get_path("p_used").is_initialized());
+	}
+	SECTION("A maximal age of zero disables column aging") {
+		pricer.set_column_aging(0, 1);
+		for (int iteration = 0; iteration < 10; iteration++) SCIP_CALL_ABORT( pricer.iterate(scip, sol) );
+		REQUIRE(pricer.get_column_count() == 2);
+		REQUIRE(data_manager.get_path("p_unused").is_initialized());
+	}
+
+	SCIP_CALL_ABORT( SCIPfreeSol(scip, &sol) );
+	SCIP_CALL_ABORT( pricer.release(scip) );
+	SCIP_CALL_ABORT( SCIPreleaseVar(scip, &used) );
+	SCIP_CALL_ABORT( SCIPreleaseVar(scip, &unused) );
+	SCIP_CALL_ABORT( SCIPfree(&scip) );
+}
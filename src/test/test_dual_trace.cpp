@@ -0,0 +1,34 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "DualTrace.hpp"
+
+TEST_CASE("Check dual trace recording", "[dual_trace]") {
+	auto filename = (std::filesystem::temp_directory_path() / "halligalli_test_dual_trace.bin").string();
+	std::vector<std::string> names = {"c_1", "c_2", "constraint_with_long_name"};
+	{
+		DualTraceWriter writer(filename, names);
+		writer.write(false, {0.0, -1.5, 2.25});
+		writer.write(true, {0.0, 0.0, 0.0});
+		writer.write(false, {3.0, 0.0, 0.0});
+	}
+
+	DualTraceReader reader(filename);
+	REQUIRE(reader.get_constraint_names() == names);
+	bool farkas;
+	std::vector<double> duals;
+	REQUIRE(reader.read(farkas, duals));
+	REQUIRE(!farkas);
+	REQUIRE(duals == std::vector<double>{0.0, -1.5, 2.25});
+	REQUIRE(reader.read(farkas, duals));
+	REQUIRE(farkas);
+	REQUIRE(duals == std::vector<double>{0.0, 0.0, 0.0});
+	REQUIRE(reader.read(farkas, duals));
+	REQUIRE(!farkas);
+	REQUIRE(duals == std::vector<double>{3.0, 0.0, 0.0});
+	REQUIRE(!reader.read(farkas, duals));
+	std::filesystem::remove(filename);
+}
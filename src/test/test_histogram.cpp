@@ -0,0 +1,50 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "Histogram.hpp"
+
+TEST_CASE("Check log-linear histogram", "[histogram]") {
+	SECTION("Small values are exact") {
+		Histogram histogram;
+		for (std::uint64_t value = 0; value < 16; value++) histogram.record(value);
+		REQUIRE(histogram.get_count() == 16);
+		REQUIRE(histogram.get_max() == 15);
+		REQUIRE(histogram.get_sum() == 120);
+		REQUIRE(histogram.get_percentile(50) == 7);
+		REQUIRE(histogram.get_percentile(100) == 15);
+	}
+	SECTION("Percentiles of large values are within the bucket precision") {
+		Histogram histogram;
+		for (std::uint64_t value = 1; value <= 100000; value++) histogram.record(value * 1000);
+		for (double percentile : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+			double exact = percentile * 1000 * 1000;
+			double reported = histogram.get_percentile(percentile);
+			REQUIRE(reported >= exact);
+			REQUIRE(reported <= exact * 1.125);
+		}
+		REQUIRE(histogram.get_percentile(100) == 100000000);
+	}
+	SECTION("Concurrent recording and merging keep every value") {
+		Histogram histogram;
+		std::vector<std::thread> workers;
+		for (int t = 0; t < 4; t++) {
+			workers.emplace_back([&]() {
+				for (std::uint64_t value = 0; value < 10000; value++) histogram.record(value);
+			});
+		}
+		for (auto& worker : workers) worker.join();
+		REQUIRE(histogram.get_count() == 40000);
+
+		Histogram total;
+		total.add(histogram);
+		total.add(histogram);
+		REQUIRE(total.get_count() == 80000);
+		REQUIRE(total.get_max() == 9999);
+		total.clear();
+		REQUIRE(total.get_count() == 0);
+		REQUIRE(total.get_percentile(50) == 0);
+	}
+}
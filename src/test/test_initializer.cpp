@@ -2,7 +2,6 @@
 #include <thread>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <catch2/catch.hpp>
 #include <objscip/objscip.h>
@@ -12,11 +11,12 @@
 #include "DataManager.hpp"
 #include "Network.hpp"
 #include "Node.hpp"
+#include "TaskPool.hpp"
 #include "initialize.hpp"
 
 TEST_CASE("Test problem initialization and data storage", "[initialize]") {
 	int tcount = (std::thread::hardware_concurrency() > 0) ? std::thread::hardware_concurrency() : 1;
-	boost::asio::thread_pool tpool(tcount);
+	TaskPool tpool(tcount);
 
 	auto lp_file_path = std::string(TEST_RES) + "/example_problem.lp";
 	auto graphs_path = std::string(TEST_RES) + "/example_problem_graphs/";
@@ -1,4 +1,11 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/graph/adjacency_list.hpp>
 #include <catch2/catch.hpp>
@@ -7,6 +14,8 @@
 #include "Network.hpp"
 #include "Node.hpp"
 #include "Path.hpp"
+#include "TaskPool.hpp"
+#include "generate_instance.hpp"
 
 TEST_CASE("Check Network class", "[network]") {
 	std::vector<Arc> arc_list;
@@ -85,5 +94,413 @@ TEST_CASE("Check Network class", "[network]") {
 			REQUIRE(shortest_path.arcs.at(1) == a_s_3);
 			REQUIRE(shortest_path.arcs.at(0) == a_3_t);
 		}
+		SECTION("Check covering paths") {
+			auto paths = net.covering_paths({ a_s_2, a_2_t, a_3_t }, 0);
+			REQUIRE(paths.size() == 2);
+			REQUIRE(paths.at(0).network_group == net.get_group());
+			REQUIRE(paths.at(0).arcs.at(1) == a_s_2);
+			REQUIRE(paths.at(0).arcs.at(0) == a_2_t);
+			REQUIRE(paths.at(1).arcs.at(1) == a_s_3);
+			REQUIRE(paths.at(1).arcs.at(0) == a_3_t);
+
+			REQUIRE(net.covering_paths({ a_s_2, a_3_t }, 1).size() == 1);
+		}
+		SECTION("Check forbidden edges") {
+			net.add_to_edge_weight(a_s_3, -1);
+			net.forbid_edge(a_s_3);
+			shortest_path = net.shortest_path();
+			REQUIRE(shortest_path.length == 0);
+			REQUIRE(shortest_path.arcs.at(1) == a_s_2);
+
+			net.forbid_edge(a_2_t);
+			net.add_to_edge_weight(a_3_t, -1);
+			shortest_path = net.shortest_path();
+			REQUIRE(shortest_path.length == std::numeric_limits<double>::infinity());
+			REQUIRE(shortest_path.arcs.empty());
+
+			net.reset_edge_weights();
+			REQUIRE(net.shortest_path().length == 0);
+		}
+		SECTION("Check path validation") {
+			REQUIRE(net.is_path({ a_2_t, a_s_2 }));
+			REQUIRE(!net.is_path({ a_s_2, a_2_t }));
+			REQUIRE(!net.is_path({ a_3_t, a_s_2 }));
+			REQUIRE(!net.is_path({ a_2_t }));
+			REQUIRE(!net.is_path({}));
+		}
+	}
+}
+
+namespace {
+	/// Shortest path length from the node without incoming arcs to the node without outgoing arcs, skipping forbidden arcs
+	double bellman_ford(const Network& net, const std::vector<Arc>& arcs, const std::unordered_set<Arc>& forbidden) {
+		std::unordered_set<Node> targets, sources;
+		for (const auto& arc : arcs) {
+			sources.insert(arc.source);
+			targets.insert(arc.target);
+		}
+		std::vector<Node> ends, starts;
+		for (const auto& node : sources) if (!targets.count(node)) starts.push_back(node);
+		for (const auto& node : targets) if (!sources.count(node)) ends.push_back(node);
+		REQUIRE(starts.size() == 1);
+		REQUIRE(ends.size() == 1);
+		const Node& source = starts[0];
+		const Node& sink = ends[0];
+
+		const double infinity = std::numeric_limits<double>::infinity();
+		std::unordered_map<Node, double> distance;
+		distance[source] = 0;
+		for (bool changed = true; changed;) {
+			changed = false;
+			for (const auto& arc : arcs) {
+				if (forbidden.count(arc)) continue;
+				auto from = distance.find(arc.source);
+				if (from == distance.end()) continue;
+				double length = from->second + net.get_edge_weight(arc);
+				auto to = distance.find(arc.target);
+				if (to != distance.end() && to->second <= length) continue;
+				distance[arc.target] = length;
+				changed = true;
+			}
+		}
+		auto res = distance.find(sink);
+		return res == distance.end() ? infinity : res->second;
+	}
+}
+
+TEST_CASE("Check shortest paths against Bellman-Ford", "[network]") {
+	std::vector<std::vector<Arc>> arc_lists;
+	std::vector<Network> networks;
+	int group = 1;
+	for (auto size : {std::make_pair(12, 40), std::make_pair(3, 5), std::make_pair(8, 25)}) {
+		InstanceParameters params;
+		params.slices = size.first;
+		params.states_min = size.second;
+		params.states_max = size.second;
+		std::string filename = (std::filesystem::temp_directory_path() / ("halligalli_test_reference_" + std::to_string(group))).string();
+		write_network(params, group++, filename);
+		arc_lists.emplace_back();
+		networks.emplace_back(filename, arc_lists.back());
+		std::filesystem::remove(filename);
+	}
+
+	// one scratch for all networks, sized by the largest, which is priced first
+	ShortestPathScratch scratch;
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> weight(-2, 5);
+	std::bernoulli_distribution forbid(0.05);
+	const double* distance_data = nullptr;
+	const std::uint32_t* pred_data = nullptr;
+	for (int round = 0; round < 4; round++) {
+		for (std::size_t n = 0; n < networks.size(); n++) {
+			auto& net = networks[n];
+			net.reset_edge_weights();
+			std::unordered_set<Arc> forbidden;
+			for (const auto& arc : arc_lists[n]) {
+				net.set_edge_weight(arc, weight(rng));
+				if (round > 0 && forbid(rng)) forbidden.insert(arc);
+			}
+			for (const auto& arc : forbidden) net.forbid_edge(arc);
+
+			const auto& path = net.shortest_path(scratch);
+			double reference = bellman_ford(net, arc_lists[n], forbidden);
+			if (std::isinf(reference)) {
+				REQUIRE(std::isinf(path.length));
+				REQUIRE(path.arcs.empty());
+				continue;
+			}
+			REQUIRE(path.length == Approx(reference));
+			REQUIRE(net.is_path(path.arcs));
+			double length = 0;
+			for (const auto& arc : path.arcs) {
+				REQUIRE(!forbidden.count(arc));
+				length += net.get_edge_weight(arc);
+			}
+			REQUIRE(length == Approx(path.length));
+
+			// the buffers of the largest network are reused by all others
+			if (!distance_data) {
+				distance_data = scratch.distance.data();
+				pred_data = scratch.pred_edge.data();
+			}
+			REQUIRE(scratch.distance.data() == distance_data);
+			REQUIRE(scratch.pred_edge.data() == pred_data);
+		}
+	}
+
+	SECTION("Forbidden edges into the sink make it unreachable") {
+		for (std::size_t n = 0; n < networks.size(); n++) {
+			auto& net = networks[n];
+			net.reset_edge_weights();
+			std::unordered_set<Node> sources;
+			for (const auto& arc : arc_lists[n]) sources.insert(arc.source);
+			for (const auto& arc : arc_lists[n]) {
+				net.add_to_edge_weight(arc, -1);
+				if (!sources.count(arc.target)) net.forbid_edge(arc);
+			}
+			const auto& path = net.shortest_path(scratch);
+			REQUIRE(path.length == std::numeric_limits<double>::infinity());
+			REQUIRE(path.arcs.empty());
+
+			// allowed again after a reset
+			net.reset_edge_weights();
+			REQUIRE(net.shortest_path(scratch).length == 0);
+		}
+	}
+}
+
+TEST_CASE("Check level-parallel shortest path", "[network]") {
+	// levels of a synthetic network have as many vertices as states, enough to be split among the workers
+	InstanceParameters params;
+	params.slices = 5;
+	params.states_min = 1500;
+	params.states_max = 1500;
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_levels_1").string();
+	write_network(params, 1, filename);
+	std::vector<Arc> arc_list;
+	Network net(filename, arc_list);
+	std::filesystem::remove(filename);
+	Network net_parallel = net;
+	REQUIRE(net.get_level_count() == params.slices + 2);
+
+	TaskPool tpool(4);
+	ShortestPathScratch scratch;
+	ShortestPathScratch scratch_parallel;
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> weight(-5, 5);
+	for (int round = 0; round < 5; round++) {
+		for (const auto& arc : arc_list) {
+			double w = weight(rng);
+			net.set_edge_weight(arc, w);
+			net_parallel.set_edge_weight(arc, w);
+		}
+		const auto& path = net.shortest_path(scratch);
+		const auto& path_parallel = net_parallel.shortest_path(scratch_parallel, tpool);
+		REQUIRE(path_parallel.length == path.length);
+		REQUIRE(path_parallel.arcs == path.arcs);
+		REQUIRE(net.is_path(path.arcs));
 	}
+	tpool.join();
+}
+
+TEST_CASE("Check network reduction", "[network]") {
+	// S -> A -> B -> C -> T is a chain of unweighted arcs, X can not reach the sink and Y is not reachable from the source
+	auto node = [](int dienstgrad, int zeitscheibe) { return Node{0, 0, dienstgrad, zeitscheibe, 0, false, 7}; };
+	std::vector<std::pair<int, Node>> nodes = {
+		{1, node(-2, -1)}, {2, node(35, -1)}, {3, node(1, 0)}, {4, node(1, 1)}, {5, node(1, 2)}, {6, node(2, 0)}, {7, node(2, 1)}, {8, node(3, 1)}
+	};
+	std::vector<std::pair<int, int>> edges = {{1, 3}, {3, 4}, {4, 5}, {5, 2}, {1, 6}, {6, 2}, {3, 7}, {8, 5}};
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_reduction_7").string();
+	{
+		std::ofstream file(filename);
+		file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<graphml><graph edgedefault=\"directed\">\n";
+		for (const auto& n : nodes) {
+			file << "<node id=\"" << n.first << "\"><data key=\"key0\">0</data><data key=\"key1\">0</data>"
+				<< "<data key=\"key2\">" << n.second.dienstgrad << "</data><data key=\"key3\">" << n.second.zeitscheibe << "</data>"
+				<< "<data key=\"key4\">0</data><data key=\"key5\">false</data><data key=\"key6\">7</data></node>\n";
+		}
+		for (const auto& e : edges) file << "<edge source=\"" << e.first << "\" target=\"" << e.second << "\"/>\n";
+		file << "</graph></graphml>\n";
+	}
+	std::vector<Arc> arc_list;
+	Network net(filename, arc_list);
+	std::filesystem::remove(filename);
+
+	Arc a_s_a = {node(-2, -1), node(1, 0)};
+	Arc a_a_b = {node(1, 0), node(1, 1)};
+	Arc a_b_c = {node(1, 1), node(1, 2)};
+	Arc a_c_t = {node(1, 2), node(35, -1)};
+	Arc a_s_d = {node(-2, -1), node(2, 0)};
+	Arc a_d_t = {node(2, 0), node(35, -1)};
+	Arc a_a_x = {node(1, 0), node(2, 1)};
+	auto stats = net.reduce([&](const Arc& arc) { return arc == a_s_d; });
+	REQUIRE(stats.vertices_before == 8);
+	REQUIRE(stats.edges_before == 8);
+	REQUIRE(stats.vertices_after == 3);
+	REQUIRE(stats.edges_after == 3);
+	REQUIRE(net.get_vertex_count() == 3);
+
+	// weights on arcs of the chain apply to the contracted edge, the path is reported with all arcs
+	net.add_to_edge_weight(a_b_c, -5);
+	net.add_to_edge_weight(a_a_x, -10);
+	REQUIRE(net.get_edge_weight(a_a_x) == 0);
+	auto path = net.shortest_path();
+	REQUIRE(path.length == -5);
+	REQUIRE(path.arcs == std::vector<Arc>({a_c_t, a_b_c, a_a_b, a_s_a}));
+	REQUIRE(net.is_path(path.arcs));
+	REQUIRE(!net.is_path({a_c_t, a_a_b, a_s_a}));
+	REQUIRE(!net.is_path({a_c_t, a_b_c, a_a_x, a_s_a}));
+
+	net.forbid_edge(a_a_b);
+	path = net.shortest_path();
+	REQUIRE(path.length == 0);
+	REQUIRE(path.arcs == std::vector<Arc>({a_d_t, a_s_d}));
+
+	auto paths = net.covering_paths({a_s_d, a_a_b, a_a_x}, 0);
+	REQUIRE(paths.size() == 2);
+	REQUIRE(paths.at(1).arcs.size() == 4);
+}
+
+TEST_CASE("Check shortest paths of reduced networks", "[network]") {
+	InstanceParameters params;
+	params.slices = 8;
+	params.states_min = 20;
+	params.states_max = 20;
+	params.branching = 1;
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_reduced_1").string();
+	write_network(params, 1, filename);
+	std::vector<Arc> arc_list;
+	Network net(filename, arc_list);
+	std::filesystem::remove(filename);
+	Network reduced = net;
+
+	// every third state carries weights, the chains of the others are contracted
+	std::vector<Arc> weighted;
+	for (const auto& arc : arc_list)
+		if (arc.target.laufbahngruppe == 1) weighted.push_back(arc);
+	auto stats = reduced.reduce([&](const Arc& arc) { return std::find(weighted.begin(), weighted.end(), arc) != weighted.end(); });
+	REQUIRE(stats.edges_after < stats.edges_before);
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> weight(-5, 5);
+	for (int round = 0; round < 5; round++) {
+		net.reset_edge_weights();
+		reduced.reset_edge_weights();
+		for (const auto& arc : weighted) {
+			double w = weight(rng);
+			net.add_to_edge_weight(arc, w);
+			reduced.add_to_edge_weight(arc, w);
+		}
+		auto path = reduced.shortest_path();
+		REQUIRE(path.length == Approx(net.shortest_path().length));
+		REQUIRE(net.is_path(path.arcs));
+		REQUIRE(reduced.is_path(path.arcs));
+		double length = 0;
+		for (const auto& arc : path.arcs) length += net.get_edge_weight(arc);
+		REQUIRE(length == Approx(path.length));
+	}
+}
+
+TEST_CASE("Check lower bound on the path length", "[network]") {
+	InstanceParameters params;
+	params.slices = 10;
+	params.states_min = 30;
+	params.states_max = 30;
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_bound_1").string();
+	write_network(params, 1, filename);
+	std::vector<Arc> arc_list;
+	Network net(filename, arc_list);
+	std::filesystem::remove(filename);
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> weight(-1, 5);
+	for (int round = 0; round < 5; round++) {
+		net.reset_edge_weights();
+		for (const auto& arc : arc_list) net.add_to_edge_weight(arc, weight(rng));
+		double bound = net.length_bound();
+		double length = net.shortest_path().length;
+		REQUIRE(bound <= length);
+		REQUIRE(net.length_bound() == length);
+
+		// after a small change, the bound from the previous sweep is tight
+		net.add_to_edge_weight(arc_list[round], 1);
+		REQUIRE(net.length_bound() == Approx(length));
+		net.add_to_edge_weight(arc_list[round], -2);
+		bound = net.length_bound();
+		REQUIRE(bound == Approx(length - 1));
+		REQUIRE(bound <= net.shortest_path().length + 1e-9);
+	}
+}
+
+TEST_CASE("Check recent shortest paths", "[network]") {
+	InstanceParameters params;
+	params.slices = 10;
+	params.states_min = 30;
+	params.states_max = 30;
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_recent_1").string();
+	write_network(params, 1, filename);
+	std::vector<Arc> arc_list;
+	Network net(filename, arc_list);
+	std::filesystem::remove(filename);
+
+	// paths are only remembered after the first call
+	double length = net.shortest_path().length;
+	REQUIRE(net.shortest_recent_path() != nullptr);
+	REQUIRE(net.shortest_recent_path()->length == length);
+	net.add_to_edge_weight(arc_list[0], 1);
+	REQUIRE(net.shortest_recent_path() == nullptr);
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> weight(-1, 5);
+	for (int round = 0; round < 8; round++) {
+		net.reset_edge_weights();
+		for (const auto& arc : arc_list) net.add_to_edge_weight(arc, weight(rng));
+		length = net.shortest_path().length;
+
+		// the recent paths are evaluated under the current weights, never shorter than the shortest path
+		net.add_to_edge_weight(arc_list[round], -3);
+		auto recent = net.shortest_recent_path();
+		REQUIRE(recent != nullptr);
+		REQUIRE(net.is_path(recent->arcs));
+		double recent_length = 0;
+		for (const auto& arc : recent->arcs) recent_length += net.get_edge_weight(arc);
+		REQUIRE(recent_length == Approx(recent->length));
+		REQUIRE(recent->length <= length + 1e-9);
+		REQUIRE(recent->length >= net.shortest_path().length - 1e-9);
+	}
+}
+
+TEST_CASE("Check state deduplication and arc lookup", "[network]") {
+	InstanceParameters params;
+	params.slices = 10;
+	params.states_min = 30;
+	params.states_max = 30;
+	std::string filename = (std::filesystem::temp_directory_path() / "halligalli_test_lookup_1").string();
+	write_network(params, 1, filename);
+	std::vector<Arc> arc_list;
+	Network net(filename, arc_list);
+	std::filesystem::remove(filename);
+
+	// every state is stored once, however many time slices it has vertices in
+	std::unordered_set<Node> states, sources, targets;
+	for (const auto& arc : arc_list) {
+		for (auto node : {arc.source, arc.target}) {
+			node.zeitscheibe = 0;
+			states.insert(node);
+		}
+		sources.insert(arc.source);
+		targets.insert(arc.target);
+	}
+	REQUIRE(net.get_state_count() == (int) states.size());
+	REQUIRE(net.get_state_count() < net.get_vertex_count());
+
+	// every arc has its own edge, also the many arcs into the sink
+	std::unordered_set<std::uint32_t> edges;
+	int sink_arcs = 0;
+	for (std::size_t a = 0; a < arc_list.size(); a++) {
+		const auto& arc = arc_list[a];
+		REQUIRE(net.has_edge(arc));
+		auto edge = net.get_edge_index(arc);
+		REQUIRE(edge < (std::uint32_t) net.get_edge_count());
+		REQUIRE(edges.insert(edge).second);
+		if (!sources.count(arc.target)) sink_arcs++;
+
+		net.set_edge_weight(arc, (double) a);
+		net.add_to_edge_weight(edge, 0.5);
+		REQUIRE(net.get_edge_weight(arc) == (double) a + 0.5);
+	}
+	REQUIRE(sink_arcs >= params.states_min);
+
+	// arcs between existing vertices in the wrong direction, of unknown states and of unknown time slices
+	const auto& arc = arc_list.front();
+	REQUIRE(!net.has_edge(Arc{arc.target, arc.source}));
+	Node unknown_state = arc.target;
+	unknown_state.dienstgrad += 1000;
+	REQUIRE(!net.has_edge(Arc{arc.source, unknown_state}));
+	Node unknown_slice = arc.target;
+	unknown_slice.zeitscheibe += 1000;
+	REQUIRE(!net.has_edge(Arc{arc.source, unknown_slice}));
+	Node other_network = arc.target;
+	other_network.netzwerk += 1;
+	REQUIRE(!net.has_edge(Arc{arc.source, other_network}));
 }
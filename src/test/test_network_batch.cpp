@@ -0,0 +1,69 @@
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "Arc.hpp"
+#include "Network.hpp"
+#include "NetworkBatch.hpp"
+#include "Path.hpp"
+#include "generate_instance.hpp"
+
+TEST_CASE("Check batched shortest paths of identical networks", "[network]") {
+	// synthetic networks with the same state count have the same topology
+	InstanceParameters params;
+	params.slices = 6;
+	params.states_min = 30;
+	params.states_max = 30;
+	std::vector<Network> networks;
+	std::vector<std::vector<Arc>> arc_lists;
+	for (int group = 1; group <= 11; group++) {
+		if (group == 11) params.states_min = params.states_max = 40;
+		std::string filename = (std::filesystem::temp_directory_path() / ("halligalli_test_batch_" + std::to_string(group))).string();
+		write_network(params, group, filename);
+		arc_lists.emplace_back();
+		networks.emplace_back(filename, arc_lists.back());
+		std::filesystem::remove(filename);
+	}
+	std::vector<Network> reference = networks;
+	std::vector<Network*> network_ptrs;
+	for (auto& net : networks) network_ptrs.push_back(&net);
+
+	auto batches = NetworkBatch::make_batches(network_ptrs);
+	REQUIRE(batches.size() == 2);
+	REQUIRE(batches[0].get_networks().size() == NetworkBatch::c_lanes);
+	REQUIRE(batches[1].get_networks().size() == 2);
+	REQUIRE(&networks[9].get_topology() == &networks[0].get_topology());
+	REQUIRE(&networks[10].get_topology() != &networks[0].get_topology());
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> weight(-5, 5);
+	std::bernoulli_distribution forbidden(0.05);
+	ShortestPathScratch scratch;
+	for (int round = 0; round < 5; round++) {
+		for (std::size_t n = 0; n < networks.size(); n++) {
+			for (const auto& arc : arc_lists[n]) {
+				double w = forbidden(rng) ? std::numeric_limits<double>::max() : weight(rng);
+				networks[n].set_edge_weight(arc, w);
+				reference[n].set_edge_weight(arc, w);
+			}
+		}
+		// a fresh network is not recomputed by the batch, a skipped one stays stale
+		networks[3].shortest_path();
+		REQUIRE(batches[1].shortest_paths(0x3) == false);
+		REQUIRE(!networks[9].is_shortest_path_fresh());
+		for (auto& batch : batches) REQUIRE(batch.shortest_paths());
+		for (auto& batch : batches) REQUIRE(!batch.shortest_paths());
+		for (std::size_t n = 0; n < networks.size() - 1; n++) {
+			REQUIRE(networks[n].is_shortest_path_fresh());
+			const auto& path = networks[n].shortest_path(scratch);
+			Path expected = reference[n].shortest_path(scratch);
+			REQUIRE(path.network_group == expected.network_group);
+			REQUIRE(path.length == expected.length);
+			REQUIRE(path.arcs == expected.arcs);
+		}
+	}
+}
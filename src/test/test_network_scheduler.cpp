@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "Arc.hpp"
+#include "Network.hpp"
+#include "NetworkScheduler.hpp"
+
+TEST_CASE("Check cost model scheduling of networks", "[network_scheduler]") {
+	std::vector<Arc> arc_list;
+	Network large(std::string(TEST_RES) + "/test_graph_26.xml", arc_list);
+	Network small(std::string(TEST_RES) + "/test_graph_shortest_path_1.xml", arc_list);
+	REQUIRE(large.get_edge_count() > small.get_edge_count());
+	std::vector<Network*> networks = {&small, &small, &large, &small, &small, &small};
+
+	auto scheduled_networks = [](const NetworkScheduler& scheduler) {
+		std::vector<std::size_t> scheduled;
+		for (const auto& queue : scheduler.get_queues())
+			for (auto batch : queue)
+				for (auto i : scheduler.get_batches()[batch]) scheduled.push_back(i);
+		std::sort(scheduled.begin(), scheduled.end());
+		return scheduled;
+	};
+
+	SECTION("Every network is scheduled once, the largest first") {
+		NetworkScheduler scheduler;
+		scheduler.plan(networks, 2);
+		REQUIRE(scheduled_networks(scheduler) == std::vector<std::size_t>({0, 1, 2, 3, 4, 5}));
+		REQUIRE(scheduler.get_batches()[scheduler.get_queues()[0][0]][0] == 2);
+		REQUIRE(scheduler.get_cost(2) > scheduler.get_cost(0));
+	}
+	SECTION("Measured runtimes replace the edge count estimate") {
+		NetworkScheduler scheduler;
+		scheduler.plan(networks, 2);
+		for (std::size_t i = 0; i < networks.size(); i++) scheduler.record_runtime(i, 1000.0);
+		scheduler.record_runtime(4, 1e6);
+		scheduler.plan(networks, 2);
+		REQUIRE(scheduler.get_cost(4) == Approx(0.5e6 + 500));
+		REQUIRE(scheduler.get_batches()[scheduler.get_queues()[0][0]] == std::vector<std::size_t>({4}));
+		REQUIRE(scheduled_networks(scheduler) == std::vector<std::size_t>({0, 1, 2, 3, 4, 5}));
+	}
+	SECTION("The static partition is balanced by size and kept across calls") {
+		NetworkScheduler scheduler;
+		REQUIRE(scheduler.partition(networks, 2));
+		REQUIRE(scheduler.get_batches().size() == networks.size());
+		REQUIRE(scheduled_networks(scheduler) == std::vector<std::size_t>({0, 1, 2, 3, 4, 5}));
+		REQUIRE(scheduler.get_batches()[scheduler.get_queues()[0][0]] == std::vector<std::size_t>({2}));
+		std::vector<int> loads;
+		for (const auto& queue : scheduler.get_queues()) {
+			loads.push_back(0);
+			for (auto batch : queue) loads.back() += networks[scheduler.get_batches()[batch][0]]->get_edge_count();
+		}
+		REQUIRE(std::abs(loads[0] - loads[1]) <= large.get_edge_count());
+		auto queues = scheduler.get_queues();
+		REQUIRE_FALSE(scheduler.partition(networks, 2));
+		REQUIRE(scheduler.get_queues() == queues);
+	}
+	SECTION("Cheap networks are batched") {
+		NetworkScheduler scheduler;
+		std::vector<Network*> many(100, &small);
+		scheduler.plan(many, 2);
+		REQUIRE(scheduler.get_batches().size() <= 2 * 8 + 1);
+		REQUIRE(scheduled_networks(scheduler).size() == 100);
+	}
+}
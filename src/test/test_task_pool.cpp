@@ -0,0 +1,86 @@
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "TaskPool.hpp"
+
+TEST_CASE("Check fork-join loops of the task pool", "[task_pool]") {
+	TaskPool tpool(4);
+
+	SECTION("parallel_for visits every index exactly once") {
+		for (std::size_t chunk_size : {0, 1, 7, 1000}) {
+			std::vector<std::atomic<int>> visits(1000);
+			tpool.parallel_for("test", visits.size(), [&](std::size_t i) { visits[i]++; }, chunk_size);
+			for (const auto& count : visits) REQUIRE(count == 1);
+		}
+		tpool.parallel_for("test", 0, [&](std::size_t) { FAIL("Called for an empty range"); });
+	}
+	SECTION("parallel_for rethrows the first exception") {
+		std::atomic<int> calls(0);
+		auto loop = [&]() {
+			tpool.parallel_for("test", 1000, [&](std::size_t i) {
+				calls++;
+				if (i == 10) throw std::runtime_error("failed");
+			}, 1);
+		};
+		REQUIRE_THROWS_AS(loop(), std::runtime_error);
+		REQUIRE(calls < 1000);
+	}
+	SECTION("parallel_for_status stops at the first status other than ok") {
+		REQUIRE(tpool.parallel_for_status("test", 100, 0, [](std::size_t) { return 0; }) == 0);
+		REQUIRE(tpool.parallel_for_status("test", 100, 0, [](std::size_t i) { return i == 42 ? 3 : 0; }) == 3);
+	}
+	SECTION("parallel_reduce combines all chunks") {
+		auto sum = tpool.parallel_reduce("test", 10000, 0L,
+			[](std::size_t i, long& acc) { acc += i; },
+			[](long a, long b) { return a + b; });
+		REQUIRE(sum == 10000L * 9999 / 2);
+	}
+	SECTION("parallel_for_queues runs every queued item once, with and without stealing") {
+		std::vector<std::vector<std::size_t>> queues = {{0, 1, 2, 3, 4, 5, 6, 7}, {8}, {}, {9, 10}};
+		for (bool steal : {true, false}) {
+			std::vector<std::atomic<int>> visits(11);
+			tpool.parallel_for_queues("test", queues, [&](std::size_t item) { visits[item]++; }, steal);
+			for (const auto& count : visits) REQUIRE(count == 1);
+		}
+	}
+	SECTION("parallel_for_queues without stealing runs every queue on the same worker in every call") {
+		// more queues than workers, queue q belongs to the worker with index q % 4
+		std::vector<std::vector<std::size_t>> queues(6);
+		for (std::size_t item = 0; item < 60; item++) queues[item % 6].push_back(item);
+		std::vector<std::thread::id> first_owner(6);
+		for (int call = 0; call < 20; call++) {
+			std::mutex owner_mutex;
+			std::vector<std::set<std::thread::id>> owners(6);
+			tpool.parallel_for_queues("test", queues, [&](std::size_t item) {
+				const std::lock_guard<std::mutex> lock(owner_mutex);
+				owners[item % 6].insert(std::this_thread::get_id());
+			}, false);
+			for (std::size_t q = 0; q < 6; q++) {
+				REQUIRE(owners[q].size() == 1);
+				if (call == 0) first_owner[q] = *owners[q].begin();
+				REQUIRE(*owners[q].begin() == first_owner[q]);
+			}
+			// in between, unrelated tasks run on arbitrary workers
+			tpool.parallel_for("test", 100, [](std::size_t) {}, 1);
+		}
+		std::set<std::thread::id> distinct(first_owner.begin(), first_owner.begin() + 4);
+		REQUIRE(distinct.size() == 4);
+		REQUIRE(first_owner[4] == first_owner[0]);
+		REQUIRE(first_owner[5] == first_owner[1]);
+	}
+	SECTION("Pinned workers keep running tasks") {
+		// binding may be refused by the environment, the pool has to work either way
+		tpool.pin_workers();
+		std::atomic<int> calls(0);
+		tpool.parallel_for("test", 100, [&](std::size_t) { calls++; });
+		REQUIRE(calls == 100);
+	}
+	tpool.join();
+}
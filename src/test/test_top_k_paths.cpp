@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "Path.hpp"
+#include "TopKPaths.hpp"
+
+TEST_CASE("Check streaming top-k path selection", "[top_k_paths]") {
+	SECTION("Winners are confirmed as soon as pending networks can not displace them") {
+		TopKPaths selection(2, 4);
+		// two slots, three networks pending: nothing is certain yet
+		REQUIRE(selection.push(Path{-1, {}, 1}).empty());
+		REQUIRE(selection.skip().empty());
+		// two networks pending, two slots, the best candidate may still be beaten twice
+		auto winners = selection.push(Path{-3, {}, 2});
+		// one network pending: the best candidate (-3) keeps at least rank 2
+		REQUIRE(winners.size() == 1);
+		REQUIRE(winners.at(0).network_group == 2);
+		winners = selection.push(Path{-2, {}, 3});
+		// no network pending: the better of -1 and -2 fills the last slot
+		REQUIRE(winners.size() == 1);
+		REQUIRE(winners.at(0).network_group == 3);
+		REQUIRE(selection.get_confirmed_count() == 2);
+	}
+	SECTION("All negative paths are confirmed if k exceeds the network count") {
+		TopKPaths selection(5, 3);
+		REQUIRE(selection.push(Path{-1, {}, 1}).size() == 1);
+		REQUIRE(selection.push(Path{-2, {}, 2}).size() == 1);
+		REQUIRE(selection.skip().empty());
+		REQUIRE(selection.get_confirmed_count() == 2);
+	}
+	SECTION("Concurrent pushes select exactly the k shortest paths") {
+		const int k = 10;
+		const int n_networks = 200;
+		TopKPaths selection(k, n_networks);
+		std::vector<std::vector<int>> confirmed_groups(4);
+		std::vector<std::thread> workers;
+		for (int t = 0; t < 4; t++) {
+			workers.emplace_back([&, t]() {
+				for (int group = t; group < n_networks; group += 4) {
+					auto winners = (group % 3 == 0) ? selection.skip() : selection.push(Path{(double) -group, {}, group});
+					for (const auto& winner : winners) confirmed_groups.at(t).push_back(winner.network_group);
+				}
+			});
+		}
+		for (auto& worker : workers) worker.join();
+
+		std::vector<int> groups;
+		for (const auto& part : confirmed_groups) groups.insert(groups.end(), part.begin(), part.end());
+		std::sort(groups.begin(), groups.end(), std::greater<int>());
+		std::vector<int> expected;
+		for (int group = n_networks - 1; (int) expected.size() < k; group--)
+			if (group % 3 != 0) expected.push_back(group);
+		REQUIRE(groups == expected);
+	}
+}